@@ -0,0 +1,196 @@
+#include "HEEP/VID/interface/CutNrs.h"
+#include "HEEP/VID/interface/HEEPColumnarReader.h"
+#include "HEEP/VID/interface/HEEPThresScanner.h"
+
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+//**********************************************************
+//
+// program: heepThresScan
+//
+// scans alternative thresholds for the HEEP V7.0 cuts using the
+// files written by HEEPV70ColumnarWriter, see HEEPThresScanner.h
+//
+// usage: heepThresScan <config> <file1.heepcol> [file2.heepcol ...]
+//
+// the config has one line per option or scan axis, # starts a comment
+//   threads <nr>       : nr of threads, default is all cores
+//   validate           : checks the first threshold of each axis reproduces the stored bits
+//   <CUT> <region> <comparison> <thres1,thres2,...> [slope slopeStart]
+//       CUT is the name in cutnrs::HEEPV70 (eg TRKISO)
+//       region is barrel, endcap or all
+//       comparison is LT, LE, GT, GE, ABSLT or ABSLE (value vs threshold)
+//       the threshold is thresN + slope*max(0,et-slopeStart)
+//       SIGMAIETAIETA is passed by electrons with saturated crystals, as in VID
+//
+// see test/heepV70ThresScan.txt for the nominal HEEP V7.0 thresholds
+//
+// prints a table with one line per grid point of the thresholds,
+// the nr passing all cuts, the efficiency and the cut flow
+//
+//**********************************************************
+
+namespace {
+  size_t cutNrFromName(const std::string& name){
+    for(unsigned int cutNr=0;cutNr<=cutnrs::HEEPV70::kMaxBitNr;cutNr++){
+      if(name==cutnrs::HEEPV70::name(cutNr)) return cutNr;
+    }
+    throw std::runtime_error("heepThresScan: unknown cut "+name);
+  }
+  HEEPThresScanner::Region regionFromName(const std::string& name){
+    if(name=="barrel") return HEEPThresScanner::Region::BARREL;
+    else if(name=="endcap") return HEEPThresScanner::Region::ENDCAP;
+    else if(name=="all") return HEEPThresScanner::Region::ALL;
+    throw std::runtime_error("heepThresScan: unknown region "+name);
+  }
+  HEEPThresScanner::Comparison comparisonFromName(const std::string& name){
+    using Comparison = HEEPThresScanner::Comparison;
+    if(name=="LT") return Comparison::LT;
+    else if(name=="LE") return Comparison::LE;
+    else if(name=="GT") return Comparison::GT;
+    else if(name=="GE") return Comparison::GE;
+    else if(name=="ABSLT") return Comparison::ABSLT;
+    else if(name=="ABSLE") return Comparison::ABSLE;
+    throw std::runtime_error("heepThresScan: unknown comparison "+name);
+  }
+
+  struct Config {
+    Config():nrThreads(std::thread::hardware_concurrency()),validate(false){}
+    size_t nrThreads;
+    bool validate;
+    std::vector<HEEPThresScanner::Axis> axes;
+  };
+
+  Config readConfig(const std::string& filename){
+    std::ifstream file(filename);
+    if(!file) throw std::runtime_error("heepThresScan: can not open "+filename);
+    Config config;
+    std::string line;
+    while(std::getline(file,line)){
+      line = line.substr(0,line.find('#'));
+      std::istringstream lineStream(line);
+      std::string key;
+      if(!(lineStream>>key)) continue;
+      if(key=="threads") lineStream>>config.nrThreads;
+      else if(key=="validate") config.validate=true;
+      else{
+	HEEPThresScanner::Axis axis;
+	std::string region,comparison,thresholds;
+	if(!(lineStream>>region>>comparison>>thresholds)) throw std::runtime_error("heepThresScan: bad line "+line);
+	axis.cutNr = cutNrFromName(key);
+	axis.region = regionFromName(region);
+	axis.comparison = comparisonFromName(comparison);
+	std::istringstream thresStream(thresholds);
+	std::string thres;
+	while(std::getline(thresStream,thres,',')) axis.constTerms.push_back(std::stof(thres));
+	axis.slope=0.;
+	axis.slopeStart=0.;
+	lineStream>>axis.slope>>axis.slopeStart;
+	//HEEP V7.0 uses GsfEleFull5x5SigmaIEtaIEtaWithSatCut with maxNrSatCrys 0 in both regions
+	if(axis.cutNr==cutnrs::HEEPV70::SIGMAIETAIETA) axis.maxNrSatCrys=0;
+	config.axes.push_back(axis);
+      }
+    }
+    return config;
+  }
+
+  //holds the columns of all the input files
+  struct EleData {
+    std::vector<uint32_t> bitmaps;
+    std::vector<float> ets;
+    std::vector<float> etas;
+    std::vector<int32_t> nrSatCryses;
+    std::vector<std::vector<float> > values;
+
+    EleData():values(cutnrs::HEEPV70::kMaxBitNr+1){}
+
+    void read(const std::string& filename){
+      heepcol::Reader reader(filename);
+      const size_t bitmapCol = reader.colIndex("bitmap");
+      const size_t nrSatCrysCol = reader.colIndex("nrSatCrys");
+      std::vector<size_t> valueCols;
+      for(unsigned int cutNr=0;cutNr<=cutnrs::HEEPV70::kMaxBitNr;cutNr++){
+	valueCols.push_back(reader.colIndex(std::string("val_")+cutnrs::HEEPV70::name(cutNr)));
+      }
+      for(size_t groupNr=0;groupNr<reader.nrRowGroups();groupNr++){
+	const size_t nrRows = reader.nrRows(groupNr);
+	const uint32_t* groupBitmaps = reader.column<uint32_t>(groupNr,bitmapCol);
+	bitmaps.insert(bitmaps.end(),groupBitmaps,groupBitmaps+nrRows);
+	const int32_t* groupNrSatCryses = reader.column<int32_t>(groupNr,nrSatCrysCol);
+	nrSatCryses.insert(nrSatCryses.end(),groupNrSatCryses,groupNrSatCryses+nrRows);
+	for(size_t cutNr=0;cutNr<values.size();cutNr++){
+	  const float* groupValues = reader.column<float>(groupNr,valueCols[cutNr]);
+	  values[cutNr].insert(values[cutNr].end(),groupValues,groupValues+nrRows);
+	}
+      }
+      //the et and eta used for the thresholds are those cut on by VID
+      ets = values[cutnrs::HEEPV70::ET];
+      etas = values[cutnrs::HEEPV70::ETA];
+    }
+
+    HEEPThresScanner::Electrons electrons()const{
+      HEEPThresScanner::Electrons eles;
+      eles.nrEles = bitmaps.size();
+      eles.bitmaps = bitmaps.data();
+      eles.ets = ets.data();
+      eles.etas = etas.data();
+      eles.nrSatCryses = nrSatCryses.data();
+      for(auto& cutValues : values) eles.values.push_back(cutValues.data());
+      return eles;
+    }
+  };
+}
+
+int main(int argc,char** argv)
+{
+  if(argc<3){
+    std::cout <<"usage: "<<argv[0]<<" <config> <file1.heepcol> [file2.heepcol ...]"<<std::endl;
+    return EXIT_FAILURE;
+  }
+  try{
+    const Config config = readConfig(argv[1]);
+    EleData eleData;
+    for(int argNr=2;argNr<argc;argNr++) eleData.read(argv[argNr]);
+    const HEEPThresScanner::Electrons eles = eleData.electrons();
+
+    const size_t nrCuts = cutnrs::HEEPV70::kMaxBitNr+1;
+    HEEPThresScanner scanner(nrCuts,config.axes);
+    std::cout <<"nr eles "<<eles.nrEles<<" nr grid points "<<scanner.nrGridPoints()<<" nr threads "<<config.nrThreads<<std::endl;
+
+    if(config.validate){
+      const auto nrMismatches = scanner.validate(eles);
+      std::cout <<"validation at first threshold:"<<std::endl;
+      for(size_t axisNr=0;axisNr<scanner.axes().size();axisNr++){
+	std::cout <<"  axis "<<axisNr<<" "<<cutnrs::HEEPV70::name(scanner.axes()[axisNr].cutNr)
+		  <<" nr mismatches "<<nrMismatches[axisNr]<<std::endl;
+      }
+    }
+
+    const auto results = scanner.scan(eles,config.nrThreads);
+    std::cout <<"point";
+    for(auto& axis : scanner.axes()) std::cout <<" "<<cutnrs::HEEPV70::name(axis.cutNr);
+    std::cout <<" nrPass eff cutFlow"<<std::endl;
+    for(size_t pointNr=0;pointNr<results.size();pointNr++){
+      const auto& result = results[pointNr];
+      std::cout <<pointNr;
+      for(size_t axisNr=0;axisNr<scanner.axes().size();axisNr++){
+	std::cout <<" "<<scanner.axes()[axisNr].constTerms[result.thresNrs[axisNr]];
+      }
+      const uint64_t nrPass = result.cutFlow.back();
+      std::cout <<" "<<nrPass<<" "<<std::setprecision(5)<<(result.nrTot!=0 ? static_cast<double>(nrPass)/result.nrTot : 0.);
+      for(auto count : result.cutFlow) std::cout <<" "<<count;
+      std::cout <<std::endl;
+    }
+  }catch(std::exception& e){
+    std::cout <<"error: "<<e.what()<<std::endl;
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,184 @@
+#include "HEEP/VID/interface/CutNrs.h"
+#include "HEEP/VID/interface/HEEPV70SIMDEvaluator.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+//**********************************************************
+//
+// program: heepV70SIMDEvaluatorCheck
+//
+// checks HEEPV70SIMDEvaluator.h on synthetic electrons, ie that
+//   the SIMD evaluate() (AVX2 or SSE2, whichever the compiler has enabled)
+//   gives the same bitmaps as evaluateBlock<heepsimd::Scalar> on every electron
+//   with a requiredMask, (bitmap & requiredMask)==requiredMask is the same as
+//   for the full bitmap and the electrons passing have the full bitmap
+//
+// the variables are put close to the thresholds (including the neighbouring
+// floats of them) so the comparisons at the edges are exercised
+//
+// it only needs the standalone headers, not CMSSW
+//
+// usage: heepV70SIMDEvaluatorCheck [nrEles] [nrRepeats]
+//
+// prints the nr of mismatches and the ns/electron of each method,
+// the exit code is non zero if there are any mismatches
+//
+//**********************************************************
+
+namespace {
+  using CutNrs = cutnrs::HEEPV70;
+
+  //the electrons as columns, see HEEPV70EleArrays
+  struct EleColumns {
+    std::vector<float> et,scEta,scEnergy,dEtaInSeed,dPhiIn,sigmaIEtaIEta,e1x5,e2x5,e5x5,hadEm,trkIso,emHadD1Iso,dxy;
+    std::vector<int> nrMissHits,ecalDriven,nrSatCrys;
+
+    HEEPV70EleArrays arrays()const{
+      return {et.data(),scEta.data(),scEnergy.data(),dEtaInSeed.data(),dPhiIn.data(),sigmaIEtaIEta.data(),
+	  e1x5.data(),e2x5.data(),e5x5.data(),hadEm.data(),trkIso.data(),emHadD1Iso.data(),dxy.data(),
+	  nrMissHits.data(),ecalDriven.data(),nrSatCrys.data()};
+    }
+  };
+
+  //half the time a value within a few floats of thres, otherwise within width/2 of it
+  class NearThres {
+  private:
+    std::mt19937 rng_;
+    std::uniform_real_distribution<double> flat_;
+  public:
+    NearThres():rng_(12345),flat_(0.,1.){}
+    double flat(){return flat_(rng_);}
+    float operator()(double thres,double width){
+      if(flat()<0.5){
+	float val = thres;
+	const int nrSteps = static_cast<int>(flat()*7)-3;
+	for(int stepNr=0;stepNr<std::abs(nrSteps);stepNr++){
+	  val = std::nextafter(val,nrSteps>0 ? 1E9f : -1E9f);
+	}
+	return val;
+      }
+      return thres+(flat()-0.5)*width;
+    }
+  };
+
+  EleColumns makeEles(size_t nrEles){
+    NearThres near;
+    EleColumns eles;
+    for(size_t eleNr=0;eleNr<nrEles;eleNr++){
+      const double etaSel = near.flat();
+      const float absEta = etaSel<0.25 ? near(1.4442,0.1) : etaSel<0.5 ? near(1.479,0.05) :
+	etaSel<0.75 ? near(1.566,0.1) : near(2.5,0.2);
+      const bool isBarrel = absEta<1.479;
+      const float et = near(35.,40.);
+      const float scEta = near.flat()<0.5 ? absEta : -absEta;
+      const float scEnergy = et*std::cosh(scEta);
+      //E5x5 of 0 for some of the electrons to check the ratios are then 0
+      const float e5x5 = near.flat()<0.05 ? 0.f : scEnergy*near(0.95,0.1);
+      eles.et.push_back(et);
+      eles.scEta.push_back(scEta);
+      eles.scEnergy.push_back(scEnergy);
+      eles.dEtaInSeed.push_back(near(isBarrel ? 0.004 : 0.006,0.004)*(near.flat()<0.5 ? 1 : -1));
+      eles.dPhiIn.push_back(near(0.06,0.05)*(near.flat()<0.5 ? 1 : -1));
+      eles.sigmaIEtaIEta.push_back(near(0.03,0.02));
+      //the ratios are put near the thresholds in double, which is how they are cut on
+      eles.e1x5.push_back(e5x5*near(0.83,0.2));
+      eles.e2x5.push_back(e5x5*near(0.94,0.1));
+      eles.e5x5.push_back(e5x5);
+      eles.hadEm.push_back(near((isBarrel ? 1. : 5.)/scEnergy+0.05,0.05));
+      eles.trkIso.push_back(near(5.,5.));
+      eles.emHadD1Iso.push_back(near(2.+0.03*et+0.28*20.,5.));
+      eles.dxy.push_back(near(isBarrel ? 0.02 : 0.05,0.03)*(near.flat()<0.5 ? 1 : -1));
+      eles.nrMissHits.push_back(static_cast<int>(near.flat()*3));
+      eles.ecalDriven.push_back(near.flat()<0.8);
+      eles.nrSatCrys.push_back(near.flat()<0.1);
+    }
+    return eles;
+  }
+
+  template<typename Func>
+  double timePerEle(size_t nrEles,size_t nrRepeats,Func func){
+    using Clock = std::chrono::steady_clock;
+    const auto start = Clock::now();
+    for(size_t repeatNr=0;repeatNr<nrRepeats;repeatNr++) func();
+    const auto end = Clock::now();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(end-start).count()/(static_cast<double>(nrEles)*nrRepeats);
+  }
+}
+
+int main(int argc,char** argv)
+{
+  const size_t nrEles = argc>1 ? std::atol(argv[1]) : 100003; //not a multiple of the SIMD width so the remainder is done too
+  const size_t nrRepeats = argc>2 ? std::atol(argv[2]) : 10;
+  const double rho = 20.3;
+
+  const EleColumns eleColumns = makeEles(nrEles);
+  const HEEPV70EleArrays eles = eleColumns.arrays();
+  const HEEPV70SIMDEvaluator heepEval;
+
+#if defined(__AVX2__)
+  std::cout <<"SIMD: AVX2"<<std::endl;
+#elif defined(__SSE2__)
+  std::cout <<"SIMD: SSE2"<<std::endl;
+#else
+  std::cout <<"SIMD: none, evaluate() is scalar"<<std::endl;
+#endif
+
+  std::vector<unsigned int> bitmaps(nrEles,0);
+  std::vector<unsigned int> scalarBitmaps(nrEles,0);
+  heepEval.evaluate(eles,nrEles,rho,bitmaps.data());
+  for(size_t eleNr=0;eleNr<nrEles;eleNr++){
+    heepEval.evaluateBlock<heepsimd::Scalar>(eles,eleNr,rho,0,scalarBitmaps.data());
+  }
+  size_t nrScalarMismatches=0;
+  size_t nrPass=0;
+  for(size_t eleNr=0;eleNr<nrEles;eleNr++){
+    if(bitmaps[eleNr]!=scalarBitmaps[eleNr]){
+      if(nrScalarMismatches<10){
+	std::cout <<"ele "<<eleNr<<" SIMD 0x"<<std::hex<<bitmaps[eleNr]<<" scalar 0x"<<scalarBitmaps[eleNr]<<std::dec<<std::endl;
+      }
+      nrScalarMismatches++;
+    }
+    if(bitmaps[eleNr]==CutNrs::kFullMask) nrPass++;
+  }
+
+  size_t nrRequiredMismatches=0;
+  const std::vector<unsigned int> requiredMasks={CutNrs::kFullMask,(0x1u<<CutNrs::ET)|(0x1u<<CutNrs::ETA),0x1u<<CutNrs::EMHADD1ISO};
+  for(const unsigned int requiredMask : requiredMasks){
+    const std::vector<unsigned int> requiredBitmaps = heepEval.evaluate(eles,nrEles,rho,requiredMask);
+    for(size_t eleNr=0;eleNr<nrEles;eleNr++){
+      const bool pass = (bitmaps[eleNr]&requiredMask)==requiredMask;
+      const bool requiredPass = (requiredBitmaps[eleNr]&requiredMask)==requiredMask;
+      if(pass!=requiredPass || (pass && requiredBitmaps[eleNr]!=bitmaps[eleNr])) nrRequiredMismatches++;
+    }
+  }
+
+  std::cout <<"nr eles "<<nrEles<<" nr pass "<<nrPass<<std::endl;
+  std::cout <<"nr SIMD vs scalar mismatches "<<nrScalarMismatches<<std::endl;
+  std::cout <<"nr requiredMask mismatches "<<nrRequiredMismatches<<std::endl;
+  std::cout <<"nr passing each cut:";
+  for(unsigned int cutNr=0;cutNr<=CutNrs::kMaxBitNr;cutNr++){
+    size_t nrPassCut=0;
+    for(auto bitmap : bitmaps) nrPassCut+=(bitmap>>cutNr)&0x1;
+    std::cout <<" "<<CutNrs::name(cutNr)<<" "<<nrPassCut;
+  }
+  std::cout <<std::endl;
+
+  const double simdTime = timePerEle(nrEles,nrRepeats,[&](){heepEval.evaluate(eles,nrEles,rho,bitmaps.data());});
+  const double scalarTime = timePerEle(nrEles,nrRepeats,[&](){
+      for(size_t eleNr=0;eleNr<nrEles;eleNr++) heepEval.evaluateBlock<heepsimd::Scalar>(eles,eleNr,rho,0,scalarBitmaps.data());
+    });
+  const double requiredTime = timePerEle(nrEles,nrRepeats,[&](){
+      heepEval.evaluate(eles,nrEles,rho,bitmaps.data(),CutNrs::kFullMask);
+    });
+  std::cout <<std::setprecision(4)
+	    <<"evaluate "<<simdTime<<" ns/ele, scalar "<<scalarTime<<" ns/ele, "
+	    <<"evaluate(requiredMask=kFullMask) "<<requiredTime<<" ns/ele"<<std::endl;
+
+  return nrScalarMismatches==0 && nrRequiredMismatches==0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
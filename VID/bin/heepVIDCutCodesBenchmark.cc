@@ -0,0 +1,121 @@
+#include "HEEP/VID/interface/CutNrs.h"
+#include "HEEP/VID/interface/VIDCutCodes.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+
+//**********************************************************
+//
+// program: heepVIDCutCodesBenchmark
+//
+// times the functions of VIDCutCodes.h on synthetic HEEP V7.0 bitmaps
+// so changes to the header can be compared against a baseline
+//
+// it only needs the standalone headers, not CMSSW
+//
+// usage: heepVIDCutCodesBenchmark [nrBitmaps] [nrRepeats]
+//
+// the bitmaps are made with each cut passing independently with the
+// pass rate in kPassRates, roughly what we see for electrons in Z->ee
+// with E_{T}>20 GeV
+//
+// prints ns/op and allocations/op for each function
+//
+//**********************************************************
+
+//counts the allocations so we can report allocations/op
+namespace {
+  uint64_t nrAllocs=0;
+}
+void* operator new(std::size_t size){
+  nrAllocs++;
+  if(void* ptr = std::malloc(size)) return ptr;
+  throw std::bad_alloc();
+}
+void operator delete(void* ptr)noexcept{std::free(ptr);}
+void operator delete(void* ptr,std::size_t)noexcept{std::free(ptr);}
+
+namespace {
+  using HEEPV70 = VIDCutCodes<cutnrs::HEEPV70>;
+
+  //index is the cut nr
+  const std::vector<double> kPassRates={0.80,0.95,0.95,0.97,0.97,0.95,0.97,0.90,0.90,0.98,0.97,0.99};
+
+  std::vector<unsigned int> makeBitmaps(size_t nrBitmaps){
+    std::mt19937 rng(12345);
+    std::uniform_real_distribution<double> flat(0.,1.);
+    std::vector<unsigned int> bitmaps;
+    bitmaps.reserve(nrBitmaps);
+    for(size_t bitmapNr=0;bitmapNr<nrBitmaps;bitmapNr++){
+      unsigned int bitmap=0x0;
+      for(size_t cutNr=0;cutNr<kPassRates.size();cutNr++){
+	if(flat(rng)<kPassRates[cutNr]) bitmap|=HEEPV70::mask(cutNr);
+      }
+      bitmaps.push_back(bitmap);
+    }
+    return bitmaps;
+  }
+
+  template<typename Func>
+  void time(const std::string& name,const std::vector<unsigned int>& bitmaps,size_t nrRepeats,Func func){
+    using Clock = std::chrono::steady_clock;
+    uint64_t nrPass=0;
+    const uint64_t nrAllocsStart = nrAllocs;
+    const auto start = Clock::now();
+    for(size_t repeatNr=0;repeatNr<nrRepeats;repeatNr++){
+      for(auto bitmap : bitmaps) nrPass+=func(bitmap);
+    }
+    const auto end = Clock::now();
+    const double nrOps = static_cast<double>(bitmaps.size())*nrRepeats;
+    const double timeNs = std::chrono::duration_cast<std::chrono::nanoseconds>(end-start).count();
+    std::cout <<std::left<<std::setw(45)<<name<<std::right
+	      <<" "<<std::setw(10)<<std::setprecision(4)<<timeNs/nrOps<<" ns/op "
+	      <<std::setw(8)<<(nrAllocs-nrAllocsStart)/nrOps<<" allocs/op "
+	      <<" pass rate "<<nrPass/nrOps<<std::endl;
+  }
+}
+
+int main(int argc,char** argv)
+{
+  const size_t nrBitmaps = argc>1 ? std::atol(argv[1]) : 1000000;
+  const size_t nrRepeats = argc>2 ? std::atol(argv[2]) : 10;
+
+  const std::vector<unsigned int> bitmaps = makeBitmaps(nrBitmaps);
+  std::cout <<"nr bitmaps "<<nrBitmaps<<" nr repeats "<<nrRepeats<<std::endl;
+
+  time("pass(bitmap,TRKISO)",bitmaps,nrRepeats,
+       [](unsigned int bitmap){return HEEPV70::pass(bitmap,HEEPV70::TRKISO);});
+  time("pass(bitmap,TRKISO,IGNORE)",bitmaps,nrRepeats,
+       [](unsigned int bitmap){return HEEPV70::pass(bitmap,HEEPV70::TRKISO,HEEPV70::IGNORE);});
+  time("pass(bitmap,{ET,SIEIE,E2X5,HADEM})",bitmaps,nrRepeats,
+       [](unsigned int bitmap){return HEEPV70::pass(bitmap,{HEEPV70::ET,HEEPV70::SIGMAIETAIETA,HEEPV70::E2X5OVER5X5,HEEPV70::HADEM});});
+  time("pass(bitmap,{TRKISO,EMHADD1ISO},IGNORE)",bitmaps,nrRepeats,
+       [](unsigned int bitmap){return HEEPV70::pass(bitmap,{HEEPV70::TRKISO,HEEPV70::EMHADD1ISO},HEEPV70::IGNORE);});
+  time("mask({ET,SIEIE,E2X5,HADEM})",bitmaps,nrRepeats,
+       [](unsigned int bitmap){
+	 const unsigned int mask = HEEPV70::mask({HEEPV70::ET,HEEPV70::SIGMAIETAIETA,HEEPV70::E2X5OVER5X5,HEEPV70::HADEM});
+	 return (bitmap&mask)==mask;
+       });
+  time("mask<ET,SIEIE,E2X5,HADEM>()",bitmaps,nrRepeats,
+       [](unsigned int bitmap){
+	 const unsigned int mask = HEEPV70::mask<HEEPV70::ET,HEEPV70::SIGMAIETAIETA,HEEPV70::E2X5OVER5X5,HEEPV70::HADEM>();
+	 return (bitmap&mask)==mask;
+       });
+  time("pass<TRKISO>(bitmap)",bitmaps,nrRepeats,
+       [](unsigned int bitmap){return HEEPV70::pass<HEEPV70::TRKISO>(bitmap);});
+  time("passIgnoring<TRKISO>(bitmap)",bitmaps,nrRepeats,
+       [](unsigned int bitmap){return HEEPV70::passIgnoring<HEEPV70::TRKISO>(bitmap);});
+  time("pass<ET,SIEIE,E2X5,HADEM>(bitmap)",bitmaps,nrRepeats,
+       [](unsigned int bitmap){return HEEPV70::pass<HEEPV70::ET,HEEPV70::SIGMAIETAIETA,HEEPV70::E2X5OVER5X5,HEEPV70::HADEM>(bitmap);});
+  time("passIgnoring<TRKISO,EMHADD1ISO>(bitmap)",bitmaps,nrRepeats,
+       [](unsigned int bitmap){return HEEPV70::passIgnoring<HEEPV70::TRKISO,HEEPV70::EMHADD1ISO>(bitmap);});
+
+  return EXIT_SUCCESS;
+}
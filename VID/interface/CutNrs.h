@@ -10,7 +10,53 @@ namespace cutnrs {
     
     constexpr static unsigned int kMaxBitNr=ECALDRIVEN;
     constexpr static unsigned int kFullMask=( 0x1 << (kMaxBitNr+1) ) -1;
+    
+    static const char* name(unsigned int cutNr){
+      static const char* names[]={"ET","ETA","DETAINSEED","DPHIIN","SIGMAIETAIETA","E2X5OVER5X5","HADEM","TRKISO","EMHADD1ISO","DXY","MISSHITS","ECALDRIVEN"};
+      return cutNr<=kMaxBitNr ? names[cutNr] : "";
+    }
+  };
+
+  //identical cuts to V7.0, only the tracker isolation configuration changed
+  class HEEPV60 {
+  public:
+    enum CutIndex {
+      ET=0,ETA,DETAINSEED,DPHIIN,SIGMAIETAIETA,E2X5OVER5X5,HADEM,TRKISO,EMHADD1ISO,DXY,MISSHITS,ECALDRIVEN
+    };
+    
+    constexpr static unsigned int kMaxBitNr=ECALDRIVEN;
+    constexpr static unsigned int kFullMask=( 0x1 << (kMaxBitNr+1) ) -1;
+    
+    static const char* name(unsigned int cutNr){return HEEPV70::name(cutNr);}
+  };
+
+  //the E/gamma cut based ID (Fall17 V2), all working points have the same cuts
+  //each working point is its own instantiation so it has its own CutIndex type,
+  //ie cutnrs::CutBasedV2Loose::HADEM can not be used for the tight working point
+  //(eg by VIDPackedBitmap) and the working points can be told apart
+  template<typename WorkingPoint>
+  class CutBasedV2 {
+  public:
+    enum CutIndex {
+      MINPT=0,SCETA,DETAINSEED,DPHIIN,SIGMAIETAIETA,HADEM,EINVMINUSPINV,RELPFISO,CONVVETO,MISSHITS
+    };
+    
+    constexpr static unsigned int kMaxBitNr=MISSHITS;
+    constexpr static unsigned int kFullMask=( 0x1 << (kMaxBitNr+1) ) -1;
+    
+    static const char* name(unsigned int cutNr){
+      static const char* names[]={"MINPT","SCETA","DETAINSEED","DPHIIN","SIGMAIETAIETA","HADEM","EINVMINUSPINV","RELPFISO","CONVVETO","MISSHITS"};
+      return cutNr<=kMaxBitNr ? names[cutNr] : "";
+    }
   };
+  struct CutBasedV2VetoWP {};
+  struct CutBasedV2LooseWP {};
+  struct CutBasedV2MediumWP {};
+  struct CutBasedV2TightWP {};
+  using CutBasedV2Veto = CutBasedV2<CutBasedV2VetoWP>;
+  using CutBasedV2Loose = CutBasedV2<CutBasedV2LooseWP>;
+  using CutBasedV2Medium = CutBasedV2<CutBasedV2MediumWP>;
+  using CutBasedV2Tight = CutBasedV2<CutBasedV2TightWP>;
 }
 
 #endif
@@ -0,0 +1,180 @@
+#ifndef HEEP_VID_HEEPColumnarFormat_h
+#define HEEP_VID_HEEPColumnarFormat_h
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+//**********************************************************
+//
+// namespace: heepcol
+//
+// a very simple fixed schema columnar binary format for HEEP
+// ntuples which can be memory mapped and scanned directly
+// (see HEEPColumnarReader.h for the reader)
+//
+// layout (all little endian, as written by the machine, no compression):
+//   FileHeader
+//   ColDesc x FileHeader::nrCols
+//   then any number of row groups, each is
+//     RowGroupHeader
+//     for each column, nrRows values of that column, padded to 8 bytes
+//
+// everything is a multiple of 8 bytes so every column array is 8 byte aligned
+// in the file and so can be used in place once mapped
+//
+//**********************************************************
+
+namespace heepcol {
+  enum class ColType : uint32_t {FLOAT=0,INT32,UINT32,UINT64};
+
+  constexpr uint32_t kVersion = 1;
+  constexpr char kFileMagic[8] = {'H','E','E','P','C','O','L','\0'};
+  constexpr char kRowGroupMagic[8] = {'R','O','W','G','R','P','\0','\0'};
+
+  struct FileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t nrCols;
+  };
+  struct ColDesc {
+    char name[48];
+    uint32_t type;
+    uint32_t padding;
+  };
+  struct RowGroupHeader {
+    char magic[8];
+    uint64_t nrRows;
+  };
+
+  inline size_t typeSize(ColType type){
+    switch(type){
+    case ColType::FLOAT: return sizeof(float);
+    case ColType::INT32: return sizeof(int32_t);
+    case ColType::UINT32: return sizeof(uint32_t);
+    case ColType::UINT64: return sizeof(uint64_t);
+    }
+    return 0;
+  }
+  inline size_t paddedSize(size_t nrBytes){return (nrBytes+7)/8*8;}
+
+  template<typename T> struct ColTypeOf;
+  template<> struct ColTypeOf<float>{static constexpr ColType value = ColType::FLOAT;};
+  template<> struct ColTypeOf<int32_t>{static constexpr ColType value = ColType::INT32;};
+  template<> struct ColTypeOf<uint32_t>{static constexpr ColType value = ColType::UINT32;};
+  template<> struct ColTypeOf<uint64_t>{static constexpr ColType value = ColType::UINT64;};
+
+  inline ColDesc makeColDesc(const std::string& name,ColType type){
+    if(name.size()>=sizeof(ColDesc::name)) throw std::runtime_error("heepcol: column name too long "+name);
+    ColDesc desc;
+    std::memset(&desc,0,sizeof(ColDesc));
+    std::strncpy(desc.name,name.c_str(),sizeof(desc.name)-1);
+    desc.type = static_cast<uint32_t>(type);
+    return desc;
+  }
+
+  //buffers the rows and writes them out as a row group every rowGroupSize rows
+  //usage:
+  //  set every column for the row via fill(colNr,value) then call endRow()
+  //  call close() at the end, it throws if the file could not be written
+  //  (the destructor closes it too if you dont but can only print the error)
+  class Writer {
+  private:
+    std::ofstream file_;
+    std::vector<ColDesc> cols_;
+    std::vector<std::vector<char> > buffers_;
+    size_t rowGroupSize_;
+    size_t nrRows_;
+
+  public:
+    Writer(const std::string& filename,const std::vector<ColDesc>& cols,size_t rowGroupSize):
+      file_(filename,std::ios::binary),cols_(cols),buffers_(cols.size()),rowGroupSize_(rowGroupSize),nrRows_(0)
+    {
+      if(!file_) throw std::runtime_error("heepcol: can not open "+filename);
+      FileHeader header;
+      std::memcpy(header.magic,kFileMagic,sizeof(header.magic));
+      header.version = kVersion;
+      header.nrCols = cols_.size();
+      file_.write(reinterpret_cast<const char*>(&header),sizeof(header));
+      file_.write(reinterpret_cast<const char*>(cols_.data()),sizeof(ColDesc)*cols_.size());
+      checkWrite();
+      for(size_t colNr=0;colNr<cols_.size();colNr++){
+	buffers_[colNr].reserve(rowGroupSize_*typeSize(static_cast<ColType>(cols_[colNr].type)));
+      }
+    }
+    //an exception escaping a destructor would terminate the job
+    ~Writer(){
+      try{
+	close();
+      }catch(std::exception& e){
+	std::cerr <<"heepcol: error closing the file, it is incomplete: "<<e.what()<<std::endl;
+      }
+    }
+    Writer(const Writer&)=delete;
+    Writer& operator=(const Writer&)=delete;
+
+    size_t nrCols()const{return cols_.size();}
+
+    template<typename T>
+    void fill(size_t colNr,T value){
+      if(static_cast<uint32_t>(ColTypeOf<T>::value)!=cols_[colNr].type){
+	throw std::runtime_error(std::string("heepcol: wrong type for column ")+cols_[colNr].name);
+      }
+      auto& buffer = buffers_[colNr];
+      const char* bytes = reinterpret_cast<const char*>(&value);
+      buffer.insert(buffer.end(),bytes,bytes+sizeof(T));
+    }
+    void endRow(){
+      nrRows_++;
+      if(nrRows_>=rowGroupSize_) flush();
+    }
+    void flush(){
+      if(nrRows_==0 || !file_.is_open()) return;
+      //checked before anything is written so a bad row group is never written
+      for(size_t colNr=0;colNr<cols_.size();colNr++){
+	const size_t expectedSize = nrRows_*typeSize(static_cast<ColType>(cols_[colNr].type));
+	if(buffers_[colNr].size()!=expectedSize){
+	  throw std::runtime_error(std::string("heepcol: column not filled for every row ")+cols_[colNr].name);
+	}
+      }
+      RowGroupHeader header;
+      std::memcpy(header.magic,kRowGroupMagic,sizeof(header.magic));
+      header.nrRows = nrRows_;
+      file_.write(reinterpret_cast<const char*>(&header),sizeof(header));
+      const char padding[8]={0};
+      for(size_t colNr=0;colNr<cols_.size();colNr++){
+	auto& buffer = buffers_[colNr];
+	file_.write(buffer.data(),buffer.size());
+	file_.write(padding,paddedSize(buffer.size())-buffer.size());
+	buffer.clear();
+      }
+      nrRows_=0;
+      checkWrite();
+    }
+    //does nothing if already closed
+    void close(){
+      if(file_.is_open()){
+	try{
+	  flush();
+	}catch(...){
+	  file_.close();
+	  throw;
+	}
+	file_.close();
+	checkWrite();
+      }
+    }
+
+  private:
+    //eg the disk is full
+    void checkWrite(){
+      if(!file_.good()) throw std::runtime_error("heepcol: error writing the file");
+    }
+  };
+}
+
+#endif
@@ -0,0 +1,145 @@
+#ifndef HEEP_VID_HEEPColumnarReader_h
+#define HEEP_VID_HEEPColumnarReader_h
+
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "HEEP/VID/interface/HEEPColumnarFormat.h"
+
+//**********************************************************
+//
+// class: heepcol::Reader
+//
+// reads a file written by HEEPV70ColumnarWriter by memory mapping it
+// the columns are returned as pointers directly into the mapped file
+// so there is no copying or unpacking
+//
+// depends only on the standard library and POSIX so you can use it
+// outside of CMSSW
+//
+// usage:
+//   heepcol::Reader reader("heepNtup.heepcol");
+//   const size_t etCol = reader.colIndex("et");
+//   for(size_t groupNr=0;groupNr<reader.nrRowGroups();groupNr++){
+//     const float* ets = reader.column<float>(groupNr,etCol);
+//     for(size_t rowNr=0;rowNr<reader.nrRows(groupNr);rowNr++){
+//       ... ets[rowNr] ...
+//
+//**********************************************************
+
+namespace heepcol {
+  class Reader {
+  private:
+    struct RowGroup {
+      uint64_t nrRows;
+      std::vector<const char*> colData;
+    };
+
+    void* data_;
+    size_t size_;
+    std::vector<ColDesc> cols_;
+    std::vector<RowGroup> rowGroups_;
+
+  public:
+    explicit Reader(const std::string& filename):data_(nullptr),size_(0){
+      const int fd = ::open(filename.c_str(),O_RDONLY);
+      if(fd<0) throw std::runtime_error("heepcol: can not open "+filename);
+      struct stat fileStat;
+      if(::fstat(fd,&fileStat)!=0){
+	::close(fd);
+	throw std::runtime_error("heepcol: can not stat "+filename);
+      }
+      size_ = fileStat.st_size;
+      if(size_>0) data_ = ::mmap(nullptr,size_,PROT_READ,MAP_PRIVATE,fd,0);
+      ::close(fd);
+      if(data_==MAP_FAILED){
+	data_=nullptr;
+	throw std::runtime_error("heepcol: can not mmap "+filename);
+      }
+      try{
+	index();
+      }catch(...){
+	unmap();
+	throw;
+      }
+    }
+    ~Reader(){unmap();}
+    Reader(const Reader&)=delete;
+    Reader& operator=(const Reader&)=delete;
+
+    size_t nrCols()const{return cols_.size();}
+    const std::vector<ColDesc>& cols()const{return cols_;}
+    size_t colIndex(const std::string& name)const{
+      for(size_t colNr=0;colNr<cols_.size();colNr++){
+	if(name==cols_[colNr].name) return colNr;
+      }
+      throw std::runtime_error("heepcol: no column "+name);
+    }
+
+    size_t nrRowGroups()const{return rowGroups_.size();}
+    size_t nrRows(size_t groupNr)const{return rowGroups_[groupNr].nrRows;}
+    size_t nrRows()const{
+      size_t sum=0;
+      for(auto& group : rowGroups_) sum+=group.nrRows;
+      return sum;
+    }
+
+    template<typename T>
+    const T* column(size_t groupNr,size_t colNr)const{
+      if(static_cast<uint32_t>(ColTypeOf<T>::value)!=cols_[colNr].type){
+	throw std::runtime_error(std::string("heepcol: wrong type requested for column ")+cols_[colNr].name);
+      }
+      return reinterpret_cast<const T*>(rowGroups_[groupNr].colData[colNr]);
+    }
+
+  private:
+    void unmap(){
+      if(data_) ::munmap(data_,size_);
+      data_=nullptr;
+    }
+    void index(){
+      const char* pos = static_cast<const char*>(data_);
+      const char* end = pos+size_;
+
+      FileHeader header;
+      if(size_<sizeof(header)) throw std::runtime_error("heepcol: file too small");
+      std::memcpy(&header,pos,sizeof(header));
+      if(std::memcmp(header.magic,kFileMagic,sizeof(header.magic))!=0) throw std::runtime_error("heepcol: not a heepcol file");
+      if(header.version!=kVersion) throw std::runtime_error("heepcol: unsupported version");
+      pos+=sizeof(header);
+
+      if(static_cast<size_t>(end-pos)<sizeof(ColDesc)*header.nrCols) throw std::runtime_error("heepcol: truncated column descriptions");
+      cols_.resize(header.nrCols);
+      std::memcpy(cols_.data(),pos,sizeof(ColDesc)*header.nrCols);
+      pos+=sizeof(ColDesc)*header.nrCols;
+
+      while(pos<end){
+	RowGroupHeader groupHeader;
+	if(static_cast<size_t>(end-pos)<sizeof(groupHeader)) throw std::runtime_error("heepcol: truncated row group");
+	std::memcpy(&groupHeader,pos,sizeof(groupHeader));
+	if(std::memcmp(groupHeader.magic,kRowGroupMagic,sizeof(groupHeader.magic))!=0) throw std::runtime_error("heepcol: bad row group");
+	pos+=sizeof(groupHeader);
+
+	RowGroup group;
+	group.nrRows = groupHeader.nrRows;
+	for(auto& col : cols_){
+	  const size_t nrBytes = paddedSize(group.nrRows*typeSize(static_cast<ColType>(col.type)));
+	  if(static_cast<size_t>(end-pos)<nrBytes) throw std::runtime_error("heepcol: truncated column data");
+	  group.colData.push_back(pos);
+	  pos+=nrBytes;
+	}
+	rowGroups_.push_back(group);
+      }
+    }
+  };
+}
+
+#endif
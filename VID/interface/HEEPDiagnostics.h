@@ -0,0 +1,110 @@
+#ifndef HEEP_VID_HEEPDiagnostics_h
+#define HEEP_VID_HEEPDiagnostics_h
+
+#include <algorithm>
+#include <cstdint>
+#include <iomanip>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+//**********************************************************
+//
+// class: HEEPDiagnostics
+//
+// a per stream buffer for the debug / mismatch messages of the
+// per electron loops, replacing writing them directly to std::cout
+// which in a multithreaded job makes the streams wait on each other
+// and mixes up their output
+//
+// each message has a category (the index of its name given to the
+// constructor), every message is counted but only the first
+// maxMsgsPerFlush of each category since the last flush are kept
+// (then one in sampleEvery if its not zero), and they are only written
+// out when flush() is called, eg at the end of the lumi section
+//
+// message() returns null if the message isnt kept so it is only
+// formatted if it will be written
+//
+// the job counts of each stream can be added together with add()
+// and printed as a summary of every category at the end of the job
+//
+// usage:
+//   enum DiagCat {NRSATCRYS,VIDMISMATCH};
+//   HEEPDiagnostics diag({"nrSatCrys","vidMismatch"},10);
+//   if(auto out = diag.message(NRSATCRYS)) *out<<"nrSatCrys "<<nrSatCrys<<std::endl;
+//   ...
+//   diag.flush(std::cout,"run 1 lumi 2"); //eg endLuminosityBlock
+//
+//**********************************************************
+
+class HEEPDiagnostics {
+private:
+  std::vector<std::string> catNames_;
+  size_t maxMsgsPerFlush_;
+  size_t sampleEvery_;
+  std::vector<uint64_t> counts_; //since the last flush
+  std::vector<uint64_t> jobCounts_;
+  std::vector<uint64_t> jobNrMsgs_; //nr kept in the job
+  std::ostringstream buffer_;
+
+public:
+  explicit HEEPDiagnostics(const std::vector<std::string>& catNames,size_t maxMsgsPerFlush=10,size_t sampleEvery=0):
+    catNames_(catNames),maxMsgsPerFlush_(maxMsgsPerFlush),sampleEvery_(sampleEvery),
+    counts_(catNames.size(),0),jobCounts_(catNames.size(),0),jobNrMsgs_(catNames.size(),0){}
+
+  //counts the message and returns the stream to write it to or null if it is not kept
+  std::ostream* message(size_t catNr){
+    count(catNr);
+    const uint64_t nrSinceFlush = counts_[catNr];
+    if(nrSinceFlush<=maxMsgsPerFlush_ ||
+       (sampleEvery_!=0 && (nrSinceFlush-maxMsgsPerFlush_)%sampleEvery_==0)){
+      jobNrMsgs_[catNr]++;
+      buffer_<<"["<<catNames_[catNr]<<"] ";
+      return &buffer_;
+    }
+    return nullptr;
+  }
+  //counts without a message
+  void count(size_t catNr){
+    counts_[catNr]++;
+    jobCounts_[catNr]++;
+  }
+
+  //writes the counts since the last flush and the kept messages in a single write
+  //does nothing if there was nothing counted
+  void flush(std::ostream& out,const std::string& title){
+    std::ostringstream summary;
+    for(size_t catNr=0;catNr<catNames_.size();catNr++){
+      if(counts_[catNr]!=0) summary<<" "<<catNames_[catNr]<<" "<<counts_[catNr];
+    }
+    if(!summary.str().empty()){
+      out<<title<<" diagnostics:"<<summary.str()<<std::endl<<buffer_.str()<<std::flush;
+    }
+    std::fill(counts_.begin(),counts_.end(),0);
+    buffer_.str("");
+    buffer_.clear();
+  }
+
+  void add(const HEEPDiagnostics& rhs){
+    for(size_t catNr=0;catNr<jobCounts_.size() && catNr<rhs.jobCounts_.size();catNr++){
+      jobCounts_[catNr]+=rhs.jobCounts_[catNr];
+      jobNrMsgs_[catNr]+=rhs.jobNrMsgs_[catNr];
+    }
+  }
+
+  uint64_t jobCount(size_t catNr)const{return jobCounts_[catNr];}
+
+  //one line per category with the nr counted and the nr of messages kept
+  void printSummary(std::ostream& out,const std::string& title)const{
+    out<<title<<" diagnostics summary:"<<std::endl;
+    for(size_t catNr=0;catNr<catNames_.size();catNr++){
+      out<<"  "<<std::left<<std::setw(25)<<catNames_[catNr]<<std::right
+	 <<" count "<<std::setw(10)<<jobCounts_[catNr]
+	 <<" written "<<std::setw(10)<<jobNrMsgs_[catNr]<<std::endl;
+    }
+  }
+};
+
+#endif
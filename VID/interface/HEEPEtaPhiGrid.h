@@ -0,0 +1,96 @@
+#ifndef HEEP_VID_HEEPEtaPhiGrid_h
+#define HEEP_VID_HEEPEtaPhiGrid_h
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+//**********************************************************
+//
+// class: HEEPEtaPhiGrid
+//
+// bins a set of objects (eg tracks) in eta and phi so all the
+// objects within binSize in eta and phi of a point can be found
+// by looking at the 3x3 bins around it rather than every object
+//
+// build() is a counting sort so its O(nrObjs), the objects of each
+// bin are then contiguous in objIndices_
+// objects beyond maxEta are put in the first / last eta bins
+//
+// usage:
+//   HEEPEtaPhiGrid grid(0.3);
+//   grid.build(trkEtas,trkPhis); //once per event
+//   grid.forEachNear(eleEta,elePhi,[&](size_t trkNr){...});
+//
+//**********************************************************
+
+class HEEPEtaPhiGrid {
+private:
+  float maxEta_;
+  float etaBinSize_;
+  float phiBinSize_;
+  int nrEtaBins_;
+  int nrPhiBins_;
+  std::vector<unsigned int> binStarts_; //the objects of bin N are objIndices_[binStarts_[N]] to objIndices_[binStarts_[N+1]]
+  std::vector<unsigned int> objIndices_;
+  std::vector<unsigned int> objBins_;
+
+public:
+  //binSize is the max distance in eta or phi of the objects wanted
+  explicit HEEPEtaPhiGrid(float binSize,float maxEta=3.0):
+    maxEta_(maxEta),etaBinSize_(binSize),phiBinSize_(binSize),nrEtaBins_(0),nrPhiBins_(0)
+  {
+    if(binSize<=0 || binSize>2*M_PI/3) throw std::invalid_argument("HEEPEtaPhiGrid: bin size must be between 0 and 2pi/3");
+    nrEtaBins_ = std::max(1,static_cast<int>(std::ceil(2*maxEta_/etaBinSize_)));
+    nrPhiBins_ = static_cast<int>(2*M_PI/binSize);
+    phiBinSize_ = 2*M_PI/nrPhiBins_;
+    binStarts_.assign(nrEtaBins_*nrPhiBins_+1,0);
+  }
+
+  template<typename Coll>
+  void build(const Coll& etas,const Coll& phis){
+    const size_t nrObjs = etas.size();
+    std::fill(binStarts_.begin(),binStarts_.end(),0);
+    objBins_.resize(nrObjs);
+    for(size_t objNr=0;objNr<nrObjs;objNr++){
+      objBins_[objNr] = bin(etaBin(etas[objNr]),phiBin(phis[objNr]));
+      binStarts_[objBins_[objNr]+1]++;
+    }
+    for(size_t binNr=1;binNr<binStarts_.size();binNr++) binStarts_[binNr]+=binStarts_[binNr-1];
+    objIndices_.resize(nrObjs);
+    std::vector<unsigned int> binFill(binStarts_.begin(),binStarts_.end()-1);
+    for(size_t objNr=0;objNr<nrObjs;objNr++) objIndices_[binFill[objBins_[objNr]]++]=objNr;
+  }
+
+  //calls func(objNr) for every object in the 3x3 bins around eta,phi
+  //this includes every object within binSize in eta and phi (and some further away)
+  template<typename Func>
+  void forEachNear(float eta,float phi,Func func)const{
+    const int centreEtaBin = etaBin(eta);
+    const int centrePhiBin = phiBin(phi);
+    const int minEtaBin = std::max(centreEtaBin-1,0);
+    const int maxEtaBin = std::min(centreEtaBin+1,nrEtaBins_-1);
+    for(int etaBinNr=minEtaBin;etaBinNr<=maxEtaBin;etaBinNr++){
+      for(int phiOffset=-1;phiOffset<=1;phiOffset++){
+	const int binNr = bin(etaBinNr,(centrePhiBin+phiOffset+nrPhiBins_)%nrPhiBins_);
+	for(unsigned int indexNr=binStarts_[binNr];indexNr<binStarts_[binNr+1];indexNr++){
+	  func(objIndices_[indexNr]);
+	}
+      }
+    }
+  }
+
+private:
+  int etaBin(float eta)const{
+    const int binNr = static_cast<int>(std::floor((eta+maxEta_)/etaBinSize_));
+    return std::min(std::max(binNr,0),nrEtaBins_-1);
+  }
+  int phiBin(float phi)const{
+    const int binNr = static_cast<int>(std::floor((phi+M_PI)/phiBinSize_))%nrPhiBins_;
+    return binNr<0 ? binNr+nrPhiBins_ : binNr;
+  }
+  int bin(int etaBinNr,int phiBinNr)const{return etaBinNr*nrPhiBins_+phiBinNr;}
+};
+
+#endif
@@ -0,0 +1,245 @@
+#ifndef HEEP_VID_HEEPThresScanner_h
+#define HEEP_VID_HEEPThresScanner_h
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+//**********************************************************
+//
+// class: HEEPThresScanner
+//
+// scans a grid of alternative thresholds for the HEEP cuts in
+// a single pass over the electrons, using the stored bitmap and
+// values cut upon (eg as written by HEEPV70ColumnarWriter)
+//
+// each axis of the grid is a single cut in a single region (barrel
+// or endcap) with a list of thresholds, the threshold is
+//   constTerm + slope * max(0, et - slopeStart)
+// and constTerm is what is scanned, the grid is every combination
+// of the thresholds of every axis
+//
+// for each grid point, the bitmap of an electron is its stored bitmap
+// with the bit of every axis applying to it (right cut, right region)
+// recalculated from the value cut upon, so cuts which are not scanned
+// or which can not be expressed in terms of their value cut upon
+// (eg E2x5/E5x5 or the rho dependent part of EM+HadD1 iso) keep their
+// stored result
+//
+// a cut which VID passes whatever its value when the electron has more than
+// maxNrSatCrys saturated crystals (the sigmaIEtaIEta cut of HEEP V7.0, ie
+// GsfEleFull5x5SigmaIEtaIEtaWithSatCut) needs maxNrSatCrys set on its axis
+// and the nr of saturated crystals of the electrons
+//
+// setting the first threshold of each axis to the nominal value,
+// validate() checks that recalculating the bits there gives the stored bits
+//
+// the electrons are split into chunks which are run in parallel and
+// the results added together
+//
+//**********************************************************
+
+class HEEPThresScanner {
+public:
+  enum class Region {BARREL,ENDCAP,ALL};
+  enum class Comparison {LT,LE,GT,GE,ABSLT,ABSLE};
+
+  struct Axis {
+    size_t cutNr;
+    Region region;
+    Comparison comparison;
+    std::vector<float> constTerms;
+    float slope;
+    float slopeStart;
+    //the cut is passed if the nr of saturated crystals is above this
+    int maxNrSatCrys = std::numeric_limits<int>::max();
+
+    bool hasSatExemption()const{return maxNrSatCrys!=std::numeric_limits<int>::max();}
+
+    float threshold(size_t thresNr,float et)const{
+      return constTerms[thresNr] + slope*std::max(0.f,et-slopeStart);
+    }
+    bool pass(float value,float thres)const{
+      switch(comparison){
+      case Comparison::LT: return value<thres;
+      case Comparison::LE: return value<=thres;
+      case Comparison::GT: return value>thres;
+      case Comparison::GE: return value>=thres;
+      case Comparison::ABSLT: return std::abs(value)<thres;
+      case Comparison::ABSLE: return std::abs(value)<=thres;
+      }
+      return false;
+    }
+    bool applies(float eta)const{
+      if(region==Region::ALL) return true;
+      const bool isBarrel = std::abs(eta)<kBarrelCutOff;
+      return region==Region::BARREL ? isBarrel : !isBarrel;
+    }
+  };
+
+  //the electrons, as pointers to columns so the memory mapped
+  //columns of a HEEPColumnarReader can be used directly
+  //values[cutNr] is the value cut upon for that cut
+  struct Electrons {
+    size_t nrEles;
+    const uint32_t* bitmaps;
+    const float* ets;
+    const float* etas;
+    const int32_t* nrSatCryses = nullptr; //only needed if an axis has maxNrSatCrys set
+    std::vector<const float*> values;
+  };
+
+  //the result of a grid point
+  //cutFlow[N] is the nr passing cuts 0 to N
+  struct Result {
+    std::vector<size_t> thresNrs; //index of the threshold for each axis
+    uint64_t nrTot;
+    std::vector<uint64_t> cutFlow;
+  };
+
+  //VID switches from the barrel to the endcap thresholds at |scEta| 1.479
+  //(the barrelCutOff of the cuts), not at the edge of the barrel acceptance
+  static constexpr float kBarrelCutOff = 1.479;
+
+private:
+  std::vector<Axis> axes_;
+  size_t nrCuts_;
+  unsigned int fullMask_;
+
+public:
+  HEEPThresScanner(size_t nrCuts,const std::vector<Axis>& axes):
+    axes_(axes),nrCuts_(nrCuts),fullMask_((0x1u<<nrCuts)-1)
+  {
+    for(auto& axis : axes_){
+      if(axis.cutNr>=nrCuts_) throw std::runtime_error("HEEPThresScanner: cut nr out of range");
+      if(axis.constTerms.empty()) throw std::runtime_error("HEEPThresScanner: axis has no thresholds");
+    }
+  }
+
+  const std::vector<Axis>& axes()const{return axes_;}
+  size_t nrGridPoints()const{
+    size_t nrPoints=1;
+    for(auto& axis : axes_) nrPoints*=axis.constTerms.size();
+    return nrPoints;
+  }
+  //the threshold indices of each axis for a grid point, the first axis changes fastest
+  std::vector<size_t> thresNrs(size_t gridPointNr)const{
+    std::vector<size_t> nrs;
+    for(auto& axis : axes_){
+      nrs.push_back(gridPointNr%axis.constTerms.size());
+      gridPointNr/=axis.constTerms.size();
+    }
+    return nrs;
+  }
+
+  std::vector<Result> scan(const Electrons& eles,size_t nrThreads)const{
+    checkSatCrys(eles);
+    const size_t nrPoints = nrGridPoints();
+    nrThreads = std::max(nrThreads,static_cast<size_t>(1));
+    std::vector<std::vector<uint64_t> > threadCounts(nrThreads);
+    std::vector<std::thread> threads;
+    const size_t chunkSize = (eles.nrEles+nrThreads-1)/nrThreads;
+    for(size_t threadNr=0;threadNr<nrThreads;threadNr++){
+      const size_t begin = std::min(threadNr*chunkSize,eles.nrEles);
+      const size_t end = std::min(begin+chunkSize,eles.nrEles);
+      threads.emplace_back([this,&eles,&threadCounts,threadNr,begin,end](){
+	  threadCounts[threadNr] = scanChunk(eles,begin,end);
+	});
+    }
+    for(auto& thread : threads) thread.join();
+
+    std::vector<Result> results(nrPoints);
+    for(size_t pointNr=0;pointNr<nrPoints;pointNr++){
+      Result& result = results[pointNr];
+      result.thresNrs = thresNrs(pointNr);
+      result.nrTot = eles.nrEles;
+      result.cutFlow.assign(nrCuts_,0);
+      for(auto& counts : threadCounts){
+	for(size_t cutNr=0;cutNr<nrCuts_;cutNr++) result.cutFlow[cutNr]+=counts[pointNr*nrCuts_+cutNr];
+      }
+    }
+    return results;
+  }
+
+  //recalculates the bits with the first threshold of every axis and compares to
+  //the stored bits, returns the nr of mismatches for each axis
+  std::vector<uint64_t> validate(const Electrons& eles)const{
+    checkSatCrys(eles);
+    std::vector<uint64_t> nrMismatches(axes_.size(),0);
+    for(size_t eleNr=0;eleNr<eles.nrEles;eleNr++){
+      for(size_t axisNr=0;axisNr<axes_.size();axisNr++){
+	const Axis& axis = axes_[axisNr];
+	if(!axis.applies(eles.etas[eleNr])) continue;
+	const bool pass = satExempt(axis,eles,eleNr) ||
+	  axis.pass(eles.values[axis.cutNr][eleNr],axis.threshold(0,eles.ets[eleNr]));
+	const bool storedPass = (eles.bitmaps[eleNr]>>axis.cutNr)&0x1;
+	if(pass!=storedPass) nrMismatches[axisNr]++;
+      }
+    }
+    return nrMismatches;
+  }
+
+private:
+  bool satExempt(const Axis& axis,const Electrons& eles,size_t eleNr)const{
+    return axis.hasSatExemption() && eles.nrSatCryses[eleNr]>axis.maxNrSatCrys;
+  }
+  void checkSatCrys(const Electrons& eles)const{
+    for(auto& axis : axes_){
+      if(axis.hasSatExemption() && eles.nrSatCryses==nullptr){
+	throw std::runtime_error("HEEPThresScanner: an axis has maxNrSatCrys set but the electrons have no nr sat crys");
+      }
+    }
+  }
+
+  //counts[pointNr*nrCuts_+cutNr]
+  std::vector<uint64_t> scanChunk(const Electrons& eles,size_t begin,size_t end)const{
+    const size_t nrPoints = nrGridPoints();
+    std::vector<uint64_t> counts(nrPoints*nrCuts_,0);
+    //for each axis, the pass/fail of each threshold for the current electron
+    //or empty if the axis doesnt apply to it
+    std::vector<std::vector<char> > axisPass(axes_.size());
+    std::vector<size_t> thresNrs(axes_.size(),0);
+
+    for(size_t eleNr=begin;eleNr<end;eleNr++){
+      const float et = eles.ets[eleNr];
+      const float eta = eles.etas[eleNr];
+      for(size_t axisNr=0;axisNr<axes_.size();axisNr++){
+	const Axis& axis = axes_[axisNr];
+	axisPass[axisNr].clear();
+	if(!axis.applies(eta)) continue;
+	const float value = eles.values[axis.cutNr][eleNr];
+	const bool exempt = satExempt(axis,eles,eleNr);
+	for(size_t thresNr=0;thresNr<axis.constTerms.size();thresNr++){
+	  axisPass[axisNr].push_back(exempt || axis.pass(value,axis.threshold(thresNr,et)));
+	}
+      }
+      //walk through the grid, the first axis changes fastest
+      std::fill(thresNrs.begin(),thresNrs.end(),0);
+      for(size_t pointNr=0;pointNr<nrPoints;pointNr++){
+	unsigned int bitmap = eles.bitmaps[eleNr]&fullMask_;
+	for(size_t axisNr=0;axisNr<axes_.size();axisNr++){
+	  if(axisPass[axisNr].empty()) continue;
+	  const unsigned int bit = 0x1u<<axes_[axisNr].cutNr;
+	  if(axisPass[axisNr][thresNrs[axisNr]]) bitmap|=bit;
+	  else bitmap&=~bit;
+	}
+	uint64_t* pointCounts = &counts[pointNr*nrCuts_];
+	for(size_t cutNr=0;cutNr<nrCuts_ && ((bitmap>>cutNr)&0x1);cutNr++) pointCounts[cutNr]++;
+
+	for(size_t axisNr=0;axisNr<axes_.size();axisNr++){
+	  if(++thresNrs[axisNr]<axes_[axisNr].constTerms.size()) break;
+	  thresNrs[axisNr]=0;
+	}
+      }
+    }
+    return counts;
+  }
+};
+
+#endif
@@ -0,0 +1,148 @@
+#ifndef HEEP_VID_HEEPTimingStats_h
+#define HEEP_VID_HEEPTimingStats_h
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+//**********************************************************
+//
+// class: HEEPTimingStats
+//
+// low overhead timing of the HEEP analyzers hot path
+//
+// each stream records per event the time spent getting the products
+// (getByToken) and the time spent in the per electron loop, plus the
+// nr of electrons, the per event latency is stored in a log binned
+// histogram (5% wide bins) so the percentiles can be worked out without
+// keeping every event and so streams can be added together
+//
+// when disabled, now() does not read the clock and addEvent does
+// nothing so it costs essentially nothing
+//
+// usage:
+//   auto start = timing_.now();
+//   ... getByToken ...
+//   auto fetched = timing_.now();
+//   ... per electron loop ...
+//   timing_.addEvent(start,fetched,timing_.now(),nrEles);
+//
+//**********************************************************
+
+class HEEPTimingStats {
+public:
+  using Clock = std::chrono::steady_clock;
+
+private:
+  static constexpr double kMinLatencyNs = 100.;
+  static constexpr double kBinRatio = 1.05;
+  static constexpr size_t kNrBins = 400; //up to ~30s
+
+  bool enabled_;
+  uint64_t nrEvents_;
+  uint64_t nrEles_;
+  double fetchNs_;
+  double loopNs_;
+  double maxLatencyNs_;
+  std::vector<uint64_t> latencyHist_;
+
+public:
+  explicit HEEPTimingStats(bool enabled=false):
+    enabled_(enabled),nrEvents_(0),nrEles_(0),fetchNs_(0.),loopNs_(0.),maxLatencyNs_(0.),
+    latencyHist_(enabled ? kNrBins : 0,0){}
+
+  bool enabled()const{return enabled_;}
+  Clock::time_point now()const{return enabled_ ? Clock::now() : Clock::time_point();}
+
+  void addEvent(Clock::time_point start,Clock::time_point fetched,Clock::time_point end,size_t nrEles){
+    if(!enabled_) return;
+    const double fetchNs = std::chrono::duration<double,std::nano>(fetched-start).count();
+    const double loopNs = std::chrono::duration<double,std::nano>(end-fetched).count();
+    nrEvents_++;
+    nrEles_+=nrEles;
+    fetchNs_+=fetchNs;
+    loopNs_+=loopNs;
+    maxLatencyNs_ = std::max(maxLatencyNs_,fetchNs+loopNs);
+    latencyHist_[bin(fetchNs+loopNs)]++;
+  }
+
+  void add(const HEEPTimingStats& rhs){
+    if(!rhs.enabled_) return;
+    if(!enabled_) *this = HEEPTimingStats(true);
+    nrEvents_+=rhs.nrEvents_;
+    nrEles_+=rhs.nrEles_;
+    fetchNs_+=rhs.fetchNs_;
+    loopNs_+=rhs.loopNs_;
+    maxLatencyNs_ = std::max(maxLatencyNs_,rhs.maxLatencyNs_);
+    for(size_t binNr=0;binNr<kNrBins;binNr++) latencyHist_[binNr]+=rhs.latencyHist_[binNr];
+  }
+
+  uint64_t nrEvents()const{return nrEvents_;}
+  uint64_t nrEles()const{return nrEles_;}
+  double elesPerSec()const{return fetchNs_+loopNs_>0 ? nrEles_/(fetchNs_+loopNs_)*1E9 : 0.;}
+
+  //the upper edge of the bin containing the fraction frac of events
+  double latencyPercentileNs(double frac)const{
+    if(nrEvents_==0) return 0.;
+    const double target = frac*nrEvents_;
+    uint64_t sum=0;
+    for(size_t binNr=0;binNr<kNrBins;binNr++){
+      sum+=latencyHist_[binNr];
+      if(sum>=target) return std::min(binUpperEdge(binNr),maxLatencyNs_);
+    }
+    return maxLatencyNs_;
+  }
+
+  //writes the stats as a json object
+  void writeJson(std::ostream& out,const std::string& indent="")const{
+    const double nrEvents = std::max(nrEvents_,static_cast<uint64_t>(1));
+    const double nrEles = std::max(nrEles_,static_cast<uint64_t>(1));
+    out<<"{"<<std::endl;
+    out<<indent<<"  \"nrEvents\": "<<nrEvents_<<","<<std::endl;
+    out<<indent<<"  \"nrEles\": "<<nrEles_<<","<<std::endl;
+    out<<indent<<"  \"elesPerSec\": "<<elesPerSec()<<","<<std::endl;
+    out<<indent<<"  \"fetchNsPerEvent\": "<<fetchNs_/nrEvents<<","<<std::endl;
+    out<<indent<<"  \"loopNsPerEvent\": "<<loopNs_/nrEvents<<","<<std::endl;
+    out<<indent<<"  \"loopNsPerEle\": "<<loopNs_/nrEles<<","<<std::endl;
+    out<<indent<<"  \"fetchFrac\": "<<(fetchNs_+loopNs_>0 ? fetchNs_/(fetchNs_+loopNs_) : 0.)<<","<<std::endl;
+    out<<indent<<"  \"eventLatencyNs\": {\"p50\": "<<latencyPercentileNs(0.5)
+       <<", \"p90\": "<<latencyPercentileNs(0.9)
+       <<", \"p99\": "<<latencyPercentileNs(0.99)
+       <<", \"max\": "<<maxLatencyNs_<<"}"<<std::endl;
+    out<<indent<<"}";
+  }
+
+  //writes the total of all streams and then each stream
+  static void writeJson(std::ostream& out,const std::string& moduleName,const std::vector<HEEPTimingStats>& streamStats){
+    HEEPTimingStats total(true);
+    for(auto& stats : streamStats) total.add(stats);
+    out<<"{"<<std::endl;
+    out<<"  \"module\": \""<<moduleName<<"\","<<std::endl;
+    out<<"  \"nrStreams\": "<<streamStats.size()<<","<<std::endl;
+    out<<"  \"total\": ";
+    total.writeJson(out,"  ");
+    out<<","<<std::endl;
+    out<<"  \"streams\": ["<<std::endl;
+    for(size_t streamNr=0;streamNr<streamStats.size();streamNr++){
+      out<<"    ";
+      streamStats[streamNr].writeJson(out,"    ");
+      out<<(streamNr+1<streamStats.size() ? "," : "")<<std::endl;
+    }
+    out<<"  ]"<<std::endl;
+    out<<"}"<<std::endl;
+  }
+
+private:
+  static size_t bin(double latencyNs){
+    if(latencyNs<=kMinLatencyNs) return 0;
+    const size_t binNr = static_cast<size_t>(std::log(latencyNs/kMinLatencyNs)/std::log(kBinRatio))+1;
+    return std::min(binNr,kNrBins-1);
+  }
+  static double binUpperEdge(size_t binNr){return kMinLatencyNs*std::pow(kBinRatio,binNr);}
+};
+
+#endif
@@ -0,0 +1,145 @@
+#ifndef HEEP_VID_HEEPUserDataAccessor_h
+#define HEEP_VID_HEEPUserDataAccessor_h
+
+#include "DataFormats/PatCandidates/interface/Electron.h"
+#include "DataFormats/PatCandidates/interface/VIDCutFlowResult.h"
+#include "FWCore/Utilities/interface/Exception.h"
+#include "HEEP/VID/interface/HEEPV70CompactResult.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+//**********************************************************
+//
+// class: HEEPUserDataAccessor
+//
+// reads the HEEP user data embeded in the pat::Electron by
+// heepV70Modifier_cfi.py (see HEEPV70PATExample for what they are)
+//
+// ele.userInt("heepElectronID_HEEPV70Bitmap") makes a new std::string
+// from the char* every call (and for the longer names this is a heap
+// allocation) before searching the names for it
+// this class makes the keys once and then resolves once per collection
+// which of them are actually present
+//
+// reading a missing trkPtIso, nrSatCrys, pass or bitmap throws, as
+// pat::Electron would, unless setAllowMissing(true) has been called in which
+// case it returns 0 / false, only do this if you really want that default
+// the cut flow result and compact result are returned as null if missing
+// as normally only one of them is embeded, so check which you have
+//
+// note: pat::PATObject does not give public access to the user values by
+// position so we still need the key to read them, we just avoid remaking
+// it each time
+//
+// usage:
+//   HEEPUserDataAccessor heepData; //once per job, eg a member of your module
+//   heepData.resolve(*eleHandle);  //once per collection
+//   for(auto& ele : *eleHandle){
+//     auto data = heepData.get(ele);
+//     ...
+//
+//**********************************************************
+
+class HEEPUserDataAccessor {
+public:
+  struct Data {
+    Data():trkPtIso(0.),nrSatCrys(0),pass(false),bitmap(0),cutFlowResult(nullptr),compactResult(nullptr){}
+    float trkPtIso;
+    int nrSatCrys;
+    bool pass;
+    unsigned int bitmap;
+    const vid::CutFlowResult* cutFlowResult; //null if not present
+    const HEEPV70CompactResult* compactResult; //null if not present
+  };
+
+private:
+  std::string trkPtIsoKey_;
+  std::string nrSatCrysKey_;
+  std::string passKey_;
+  std::string bitmapKey_;
+  std::string cutFlowResultKey_;
+  std::string compactResultKey_;
+
+  bool hasTrkPtIso_;
+  bool hasNrSatCrys_;
+  bool hasPass_;
+  bool hasBitmap_;
+  bool hasCutFlowResult_;
+  bool hasCompactResult_;
+  bool allowMissing_;
+
+public:
+  HEEPUserDataAccessor(const std::string& trkPtIsoKey="trkPtIso",
+		       const std::string& nrSatCrysKey="nrSatCrys",
+		       const std::string& passKey="heepElectronID_HEEPV70",
+		       const std::string& bitmapKey="heepElectronID_HEEPV70Bitmap",
+		       const std::string& cutFlowResultKey="heepElectronID_HEEPV70",
+		       const std::string& compactResultKey="heepElectronID_HEEPV70Compact"):
+    trkPtIsoKey_(trkPtIsoKey),nrSatCrysKey_(nrSatCrysKey),passKey_(passKey),
+    bitmapKey_(bitmapKey),cutFlowResultKey_(cutFlowResultKey),compactResultKey_(compactResultKey),
+    hasTrkPtIso_(true),hasNrSatCrys_(true),hasPass_(true),hasBitmap_(true),hasCutFlowResult_(true),
+    hasCompactResult_(true),allowMissing_(false){}
+
+  //if true, missing trkPtIso, nrSatCrys, pass and bitmap keys give 0 / false rather than throwing
+  void setAllowMissing(bool allowMissing){allowMissing_=allowMissing;}
+
+  //works out which keys are present using the first electron
+  //all electrons of a collection are made by the same modifiers so have the same user data
+  //if the collection is empty, it keeps the previous resolution
+  template<typename EleColl>
+  void resolve(const EleColl& eles){
+    if(!eles.empty()) resolve(eles[0]);
+  }
+  void resolve(const pat::Electron& ele){
+    hasTrkPtIso_ = contains(ele.userFloatNames(),trkPtIsoKey_);
+    hasNrSatCrys_ = contains(ele.userIntNames(),nrSatCrysKey_);
+    hasPass_ = contains(ele.userIntNames(),passKey_);
+    hasBitmap_ = contains(ele.userIntNames(),bitmapKey_);
+    hasCutFlowResult_ = contains(ele.userDataNames(),cutFlowResultKey_);
+    hasCompactResult_ = contains(ele.userDataNames(),compactResultKey_);
+  }
+
+  float trkPtIso(const pat::Electron& ele)const{
+    return hasTrkPtIso_ ? ele.userFloat(trkPtIsoKey_) : missing(trkPtIsoKey_,0.f);
+  }
+  int nrSatCrys(const pat::Electron& ele)const{
+    return hasNrSatCrys_ ? ele.userInt(nrSatCrysKey_) : missing(nrSatCrysKey_,0);
+  }
+  bool pass(const pat::Electron& ele)const{
+    return hasPass_ ? ele.userInt(passKey_) : missing(passKey_,false);
+  }
+  unsigned int bitmap(const pat::Electron& ele)const{
+    return hasBitmap_ ? ele.userInt(bitmapKey_) : missing(bitmapKey_,0u);
+  }
+  const vid::CutFlowResult* cutFlowResult(const pat::Electron& ele)const{
+    return hasCutFlowResult_ ? ele.userData<vid::CutFlowResult>(cutFlowResultKey_) : nullptr;
+  }
+  const HEEPV70CompactResult* compactResult(const pat::Electron& ele)const{
+    return hasCompactResult_ ? ele.userData<HEEPV70CompactResult>(compactResultKey_) : nullptr;
+  }
+
+  Data get(const pat::Electron& ele)const{
+    Data data;
+    data.trkPtIso = trkPtIso(ele);
+    data.nrSatCrys = nrSatCrys(ele);
+    data.pass = pass(ele);
+    data.bitmap = bitmap(ele);
+    data.cutFlowResult = cutFlowResult(ele);
+    data.compactResult = compactResult(ele);
+    return data;
+  }
+
+private:
+  template<typename T>
+  T missing(const std::string& key,T defaultVal)const{
+    if(!allowMissing_) throw cms::Exception("HEEPUserDataAccessor") <<"HEEPUserDataAccessor: key "<<key<<" not present";
+    return defaultVal;
+  }
+  static bool contains(const std::vector<std::string>& names,const std::string& key){
+    return std::find(names.begin(),names.end(),key)!=names.end();
+  }
+};
+
+#endif
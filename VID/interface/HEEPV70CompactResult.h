@@ -0,0 +1,99 @@
+#ifndef HEEP_VID_HEEPV70CompactResult_h
+#define HEEP_VID_HEEPV70CompactResult_h
+
+#include "HEEP/VID/interface/CutNrs.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+//**********************************************************
+//
+// class: HEEPV70CompactResult
+//
+// a compact version of the vid::CutFlowResult of HEEP V7.0 for
+// embeding in pat::Electrons
+//
+// a vid::CutFlowResult stores the ID name, hash, a map of the cut
+// names and a vector of the decisions and values for every electron,
+// but for HEEP V7.0 the cuts are fixed by cutnrs::HEEPV70 so all
+// we need is the bitmap and the value cut upon for each cut, the
+// cut names are those of cutnrs::HEEPV70 (ie stored once in the code
+// not in every electron)
+//
+// optionally the values can be stored with fewer bits of mantissa
+// (rounded to nearest), this doesnt change their size in memory but
+// the zeroed bits compress away on disk, eg 10 bits is ~0.1% precision
+// the bitmap is always exact so the cut decisions do not change
+//
+// the accessors have the same names as vid::CutFlowResult so it can be
+// used in place of it (and with VIDCutFlowView)
+//
+// HEEPV70ElectronEmbedder will embed it, see compactVIDResultLabel
+//
+//**********************************************************
+
+class HEEPV70CompactResult {
+public:
+  static constexpr unsigned int kNrCuts = cutnrs::HEEPV70::kMaxBitNr+1;
+  static constexpr unsigned int kNrMantissaBits = 23; //of a float, ie full precision
+
+private:
+  unsigned int bitmap_;
+  float values_[kNrCuts];
+
+public:
+  HEEPV70CompactResult():bitmap_(0){std::fill(values_,values_+kNrCuts,0.f);}
+  //CutFlowResult is a vid::CutFlowResult (templated so this header is standalone)
+  template<typename CutFlowResult>
+  explicit HEEPV70CompactResult(const CutFlowResult& result,unsigned int nrMantissaBits=kNrMantissaBits):
+    bitmap_(result.cutFlowBits() & cutnrs::HEEPV70::kFullMask)
+  {
+    for(unsigned int cutNr=0;cutNr<kNrCuts;cutNr++){
+      values_[cutNr] = reducePrecision(result.getValueCutUpon(cutNr),nrMantissaBits);
+    }
+  }
+
+  unsigned int cutFlowBits()const{return bitmap_;}
+  bool cutFlowPassed()const{return bitmap_==cutnrs::HEEPV70::kFullMask;}
+  size_t cutFlowSize()const{return kNrCuts;}
+  bool getCutResultByIndex(unsigned int cutNr)const{
+    checkCutNr(cutNr);
+    return (bitmap_>>cutNr)&0x1;
+  }
+  double getValueCutUpon(unsigned int cutNr)const{
+    checkCutNr(cutNr);
+    return values_[cutNr];
+  }
+  static const char* getNameAtIndex(unsigned int cutNr){
+    checkCutNr(cutNr);
+    return cutnrs::HEEPV70::name(cutNr);
+  }
+
+  //the most a value can change when rounded to nrMantissaBits of mantissa
+  //ie |reducePrecision(value,nrMantissaBits)-value|<=maxRoundingError(value,nrMantissaBits)
+  static float maxRoundingError(float value,unsigned int nrMantissaBits){
+    if(nrMantissaBits>=kNrMantissaBits || !std::isfinite(value)) return 0.f;
+    return std::ldexp(std::abs(value),-static_cast<int>(nrMantissaBits+1));
+  }
+  //rounds value to nrMantissaBits of mantissa
+  static float reducePrecision(float value,unsigned int nrMantissaBits){
+    if(nrMantissaBits>=kNrMantissaBits || !std::isfinite(value)) return value;
+    uint32_t bits;
+    std::memcpy(&bits,&value,sizeof(bits));
+    const uint32_t shift = kNrMantissaBits-nrMantissaBits;
+    bits += 0x1u<<(shift-1);
+    bits &= ~((0x1u<<shift)-1);
+    std::memcpy(&value,&bits,sizeof(bits));
+    return value;
+  }
+
+private:
+  static void checkCutNr(unsigned int cutNr){
+    if(cutNr>=kNrCuts) throw std::out_of_range("HEEPV70CompactResult: cut nr out of range");
+  }
+};
+
+#endif
@@ -0,0 +1,457 @@
+#ifndef HEEP_VID_HEEPV70SIMDEvaluator_h
+#define HEEP_VID_HEEPV70SIMDEvaluator_h
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#include "HEEP/VID/interface/CutNrs.h"
+
+//**********************************************************
+//
+// class: HEEPV70SIMDEvaluator
+//
+// works out the HEEP V7.0 VID bitmap (ie egmGsfElectronIDs:heepElectronID-HEEPV70Bitmap,
+// bit X = cut X of cutnrs::HEEPV70) for a whole collection of electrons
+// stored as structure of arrays (HEEPV70EleArrays), without the framework
+//
+// the cuts are those of heepElectronID_HEEPV70_cff.py (HEEPV70Cuts has
+// the defaults) with the same comparisons as the VID cuts, in particular
+//   the barrel/endcap thresholds are chosen by |scEta|<1.479
+//   the saturation cuts pass if nrSatCrys > maxNrSatCrys
+//   E2x5/E5x5 passes if E1x5/E5x5 or E2x5/E5x5 is above its minimum,
+//   the ratios being taken in double (0 if E5x5 is 0)
+//   H/E is cut as hadEm*scEnergy < constTerm + slopeTerm*max(0,scEnergy-slopeStart)
+//   EM+HadD1 iso has the rho term rhoEA*rho if et >= rhoEtStart
+// VID compares the float values to double thresholds, the constant
+// thresholds are converted to the float which gives the same result
+// for every float value and the E_{T}/energy dependent thresholds and
+// the E1x5/E5x5, E2x5/E5x5 ratios are calculated in double, so for the
+// same float inputs the comparisons are those of VID
+// note: several inputs are doubles in reco::GsfElectron / VID which are
+// rounded to float here, so an electron within a float rounding (~1E-7
+// relative) of a threshold can get a different bit to VID, these are
+//   et (pt(), for ET and the E_{T} dependent thresholds)
+//   scEta (ETA and the barrel/endcap choice, eg at 1.4442, 1.479, 1.566, 2.5)
+//   scEnergy (both sides of the HADEM cut)
+//   dEtaInSeed (which VID calculates in double) and dxy
+// the agreement with VID on real electrons has not been measured yet, run
+// HEEPV70Example with checkSIMDEvaluator=True (simdBitmapMismatch in the
+// job summary) to check it
+//
+// the cuts are evaluated in order of cost, the simple float cuts
+// (ET, ETA, ECALDRIVEN, MISSHITS, ...) first and the double precision
+// ones (E2X5OVER5X5, TRKISO, HADEM, EMHADD1ISO) last
+// if requiredMask is not zero, a block of electrons stops being evaluated
+// as soon as all of them have failed one of the cuts in requiredMask and
+// the bits of the cuts not evaluated are left as 0, ie then
+// (bitmap & requiredMask)==requiredMask is right for every electron but
+// the rest of the bitmap only for the electrons passing requiredMask
+// (which is what a trigger like selection needs)
+//
+// uses AVX2 or SSE2 if the compiler has it enabled, otherwise falls back
+// to plain scalar code, the results are identical in all cases
+// (the same kernel is used for all of them)
+//
+// usage:
+//   HEEPV70SIMDEvaluator heepEval;
+//   HEEPV70EleArrays eles; eles.et = ets.data(); ...
+//   heepEval.evaluate(eles,nrEles,rho,bitmaps.data());
+//   heepEval.evaluate(eles,nrEles,rho,bitmaps.data(),cutnrs::HEEPV70::kFullMask); //only pass/fail needed
+//
+//**********************************************************
+
+//the electron variables, each an array of one entry per electron
+//et is the electron E_{T} (=pt as VID uses), scEta / scEnergy of the supercluster
+//ecalDriven is 0 or 1 (GsfElectron::ecalDriven(), not ecalDrivenSeed()) and nrSatCrys the saturated crystals in the 5x5 (eleNrSaturateIn5x5)
+struct HEEPV70EleArrays {
+  const float* et;
+  const float* scEta;
+  const float* scEnergy;
+  const float* dEtaInSeed;
+  const float* dPhiIn;
+  const float* sigmaIEtaIEta; //full 5x5
+  const float* e1x5; //full 5x5
+  const float* e2x5; //full 5x5 E2x5 max
+  const float* e5x5; //full 5x5
+  const float* hadEm;
+  const float* trkIso;
+  const float* emHadD1Iso; //dr03 ecal rec hit sum et + hcal depth 1 tower sum et
+  const float* dxy;
+  const int* nrMissHits;
+  const int* ecalDriven;
+  const int* nrSatCrys;
+};
+
+struct HEEPV70Cuts {
+  //threshold = constTerm + slopeTerm*max(0,x-slopeStart) + (x>=rhoEtStart ? rhoEA*rho : 0)
+  struct LinearCut {
+    double constTerm;
+    double slopeTerm;
+    double slopeStart;
+    double rhoEA;
+    double rhoEtStart;
+  };
+  struct RegionCuts {
+    double maxDEtaInSeed;
+    double maxDPhiIn;
+    double maxSigmaIEtaIEta;
+    double minE1x5OverE5x5;
+    double minE2x5OverE5x5;
+    int maxNrSatCrys;
+    LinearCut hadEm;
+    LinearCut trkIso;
+    LinearCut emHadD1Iso;
+    double maxDxy;
+    int maxNrMissHits;
+    bool requireEcalDriven;
+  };
+
+  double minEt = 35.;
+  double barrelCutOff = 1.479;
+  //allowed |scEta| ranges, inclusive
+  double barrelMinAbsEta = 0.;
+  double barrelMaxAbsEta = 1.4442;
+  double endcapMinAbsEta = 1.566;
+  double endcapMaxAbsEta = 2.5;
+  RegionCuts barrel = {0.004,0.06,9999.,0.83,0.94,0,
+		       {1.,0.05,0.,0.,0.},{5.,0.,0.,0.,0.},{2.,0.03,0.,0.28,0.},
+		       0.02,1,true};
+  RegionCuts endcap = {0.006,0.06,0.03,-1.,-1.,0,
+		       {5.,0.05,0.,0.,0.},{5.,0.,0.,0.,0.},{2.5,0.03,50.,0.28,0.},
+		       0.05,1,true};
+};
+
+namespace heepsimd {
+  //the float which compares the same to every float value as the double thres
+  //ie val<thres == val<ceilFloat(thres) and val<=thres == val<=floorFloat(thres)
+  inline float ceilFloat(double thres){
+    float val = static_cast<float>(thres);
+    if(static_cast<double>(val)<thres) val = std::nextafter(val,std::numeric_limits<float>::infinity());
+    return val;
+  }
+  inline float floorFloat(double thres){
+    float val = static_cast<float>(thres);
+    if(static_cast<double>(val)>thres) val = std::nextafter(val,-std::numeric_limits<float>::infinity());
+    return val;
+  }
+
+  //the thresholds of a region, converted as needed for the float comparisons
+  struct FloatCuts {
+    float maxDEtaInSeed;
+    float maxDPhiIn;
+    float maxSigmaIEtaIEta;
+    float maxNrSatCrys;
+    float maxDxy;
+    float maxNrMissHits;
+    float minEcalDriven; //0 = no requirement
+
+    explicit FloatCuts(const HEEPV70Cuts::RegionCuts& cuts):
+      maxDEtaInSeed(ceilFloat(cuts.maxDEtaInSeed)), //these are all "<" or ">" comparisons
+      maxDPhiIn(ceilFloat(cuts.maxDPhiIn)),
+      maxSigmaIEtaIEta(ceilFloat(cuts.maxSigmaIEtaIEta)),
+      maxNrSatCrys(cuts.maxNrSatCrys),
+      maxDxy(ceilFloat(cuts.maxDxy)),
+      maxNrMissHits(cuts.maxNrMissHits),
+      minEcalDriven(cuts.requireEcalDriven ? 1 : 0){}
+  };
+
+  //the operations of the kernel, each struct does kNrLanes electrons at a time
+  //F is the floats, M the mask of a comparison and I the bitmaps
+  //linearLess(lhs,lhsScale,xVal,scEta,...) is lhs*lhsScale < threshold(xVal) in double
+  //with the barrel or endcap LinearCut chosen by |scEta|<barrelCutOff
+  //ratioGreater(num,den,scEta,...) is (den!=0 ? num/den : 0) > the barrel or endcap minimum in double
+  struct Scalar {
+    using F = float;
+    using M = bool;
+    using I = unsigned int;
+    static constexpr size_t kNrLanes = 1;
+    static constexpr int kAllLanes = 0x1;
+
+    static F load(const float* vals){return *vals;}
+    static F load(const int* vals){return static_cast<float>(*vals);}
+    static F set1(float val){return val;}
+    static F abs(F val){return std::abs(val);}
+    static M lt(F lhs,F rhs){return lhs<rhs;}
+    static M le(F lhs,F rhs){return lhs<=rhs;}
+    static M gt(F lhs,F rhs){return lhs>rhs;}
+    static M ge(F lhs,F rhs){return lhs>=rhs;}
+    static M mAnd(M lhs,M rhs){return lhs && rhs;}
+    static M mOr(M lhs,M rhs){return lhs || rhs;}
+    static F select(M mask,F lhs,F rhs){return mask ? lhs : rhs;}
+    static int laneMask(M mask){return mask;}
+    static I zero(){return 0;}
+    static I addBit(I bitmap,M mask,unsigned int bit){return mask ? bitmap|bit : bitmap;}
+    static void store(unsigned int* bitmaps,I bitmap){*bitmaps=bitmap;}
+
+    static M linearLess(F lhs,F lhsScale,F xVal,F scEta,const HEEPV70Cuts::LinearCut& barrel,
+			const HEEPV70Cuts::LinearCut& endcap,double barrelCutOff,double rho){
+      const HEEPV70Cuts::LinearCut& cut = std::abs(static_cast<double>(scEta))<barrelCutOff ? barrel : endcap;
+      const double xValD = xVal;
+      const double thres = cut.constTerm + cut.slopeTerm*std::max(0.,xValD-cut.slopeStart)
+	+ (xValD>=cut.rhoEtStart ? cut.rhoEA*rho : 0.);
+      return static_cast<double>(lhs)*static_cast<double>(lhsScale) < thres;
+    }
+    static M ratioGreater(F num,F den,F scEta,double barrelMin,double endcapMin,double barrelCutOff){
+      const double minRatio = std::abs(static_cast<double>(scEta))<barrelCutOff ? barrelMin : endcapMin;
+      const double ratio = den!=0 ? static_cast<double>(num)/static_cast<double>(den) : 0.;
+      return ratio>minRatio;
+    }
+  };
+
+#if defined(__SSE2__)
+  struct SSE2 {
+    using F = __m128;
+    using M = __m128;
+    using I = __m128i;
+    static constexpr size_t kNrLanes = 4;
+    static constexpr int kAllLanes = 0xF;
+
+    static F load(const float* vals){return _mm_loadu_ps(vals);}
+    static F load(const int* vals){return _mm_cvtepi32_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(vals)));}
+    static F set1(float val){return _mm_set1_ps(val);}
+    static F abs(F val){return _mm_andnot_ps(_mm_set1_ps(-0.f),val);}
+    static M lt(F lhs,F rhs){return _mm_cmplt_ps(lhs,rhs);}
+    static M le(F lhs,F rhs){return _mm_cmple_ps(lhs,rhs);}
+    static M gt(F lhs,F rhs){return _mm_cmpgt_ps(lhs,rhs);}
+    static M ge(F lhs,F rhs){return _mm_cmpge_ps(lhs,rhs);}
+    static M mAnd(M lhs,M rhs){return _mm_and_ps(lhs,rhs);}
+    static M mOr(M lhs,M rhs){return _mm_or_ps(lhs,rhs);}
+    static F select(M mask,F lhs,F rhs){return _mm_or_ps(_mm_and_ps(mask,lhs),_mm_andnot_ps(mask,rhs));}
+    static int laneMask(M mask){return _mm_movemask_ps(mask);}
+    static I zero(){return _mm_setzero_si128();}
+    static I addBit(I bitmap,M mask,unsigned int bit){
+      return _mm_or_si128(bitmap,_mm_and_si128(_mm_castps_si128(mask),_mm_set1_epi32(static_cast<int>(bit))));
+    }
+    static void store(unsigned int* bitmaps,I bitmap){_mm_storeu_si128(reinterpret_cast<__m128i*>(bitmaps),bitmap);}
+
+    static M linearLess(F lhs,F lhsScale,F xVal,F scEta,const HEEPV70Cuts::LinearCut& barrel,
+			const HEEPV70Cuts::LinearCut& endcap,double barrelCutOff,double rho){
+      const int lowBits = linearLess(_mm_cvtps_pd(lhs),_mm_cvtps_pd(lhsScale),_mm_cvtps_pd(xVal),_mm_cvtps_pd(scEta),
+				     barrel,endcap,barrelCutOff,rho);
+      const int highBits = linearLess(highHalf(lhs),highHalf(lhsScale),highHalf(xVal),highHalf(scEta),
+				      barrel,endcap,barrelCutOff,rho);
+      return fromLaneBits(lowBits|(highBits<<2));
+    }
+    static M ratioGreater(F num,F den,F scEta,double barrelMin,double endcapMin,double barrelCutOff){
+      const int lowBits = ratioGreater(_mm_cvtps_pd(num),_mm_cvtps_pd(den),_mm_cvtps_pd(scEta),
+				       barrelMin,endcapMin,barrelCutOff);
+      const int highBits = ratioGreater(highHalf(num),highHalf(den),highHalf(scEta),
+					barrelMin,endcapMin,barrelCutOff);
+      return fromLaneBits(lowBits|(highBits<<2));
+    }
+  private:
+    static __m128d highHalf(F vals){return _mm_cvtps_pd(_mm_movehl_ps(vals,vals));}
+    //the mask with lane N set if bit N of laneBits is
+    static M fromLaneBits(int laneBits){
+      const __m128i bitOfLane = _mm_setr_epi32(0x1,0x2,0x4,0x8);
+      const __m128i bits = _mm_and_si128(_mm_set1_epi32(laneBits),bitOfLane);
+      return _mm_castsi128_ps(_mm_cmpeq_epi32(bits,bitOfLane));
+    }
+    static __m128d select(__m128d mask,double lhs,double rhs){
+      return _mm_or_pd(_mm_and_pd(mask,_mm_set1_pd(lhs)),_mm_andnot_pd(mask,_mm_set1_pd(rhs)));
+    }
+    //den is set to 1 where it is 0 so nothing is divided by 0 (which would trap with FP exceptions on)
+    static int ratioGreater(__m128d num,__m128d den,__m128d scEta,double barrelMin,double endcapMin,double barrelCutOff){
+      const __m128d isBarrel = _mm_cmplt_pd(_mm_andnot_pd(_mm_set1_pd(-0.),scEta),_mm_set1_pd(barrelCutOff));
+      const __m128d denIsZero = _mm_cmpeq_pd(den,_mm_setzero_pd());
+      const __m128d safeDen = _mm_or_pd(_mm_and_pd(denIsZero,_mm_set1_pd(1.)),_mm_andnot_pd(denIsZero,den));
+      const __m128d ratio = _mm_andnot_pd(denIsZero,_mm_div_pd(num,safeDen));
+      return _mm_movemask_pd(_mm_cmpgt_pd(ratio,select(isBarrel,barrelMin,endcapMin)));
+    }
+    static int linearLess(__m128d lhs,__m128d lhsScale,__m128d xVal,__m128d scEta,const HEEPV70Cuts::LinearCut& barrel,
+			  const HEEPV70Cuts::LinearCut& endcap,double barrelCutOff,double rho){
+      const __m128d isBarrel = _mm_cmplt_pd(_mm_andnot_pd(_mm_set1_pd(-0.),scEta),_mm_set1_pd(barrelCutOff));
+      const __m128d slopeEt = _mm_max_pd(_mm_setzero_pd(),_mm_sub_pd(xVal,select(isBarrel,barrel.slopeStart,endcap.slopeStart)));
+      const __m128d rhoTerm = _mm_and_pd(_mm_cmpge_pd(xVal,select(isBarrel,barrel.rhoEtStart,endcap.rhoEtStart)),
+					 _mm_mul_pd(select(isBarrel,barrel.rhoEA,endcap.rhoEA),_mm_set1_pd(rho)));
+      const __m128d thres = _mm_add_pd(_mm_add_pd(select(isBarrel,barrel.constTerm,endcap.constTerm),
+						  _mm_mul_pd(select(isBarrel,barrel.slopeTerm,endcap.slopeTerm),slopeEt)),rhoTerm);
+      return _mm_movemask_pd(_mm_cmplt_pd(_mm_mul_pd(lhs,lhsScale),thres));
+    }
+  };
+#endif
+
+#if defined(__AVX2__)
+  struct AVX2 {
+    using F = __m256;
+    using M = __m256;
+    using I = __m256i;
+    static constexpr size_t kNrLanes = 8;
+    static constexpr int kAllLanes = 0xFF;
+
+    static F load(const float* vals){return _mm256_loadu_ps(vals);}
+    static F load(const int* vals){return _mm256_cvtepi32_ps(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(vals)));}
+    static F set1(float val){return _mm256_set1_ps(val);}
+    static F abs(F val){return _mm256_andnot_ps(_mm256_set1_ps(-0.f),val);}
+    static M lt(F lhs,F rhs){return _mm256_cmp_ps(lhs,rhs,_CMP_LT_OQ);}
+    static M le(F lhs,F rhs){return _mm256_cmp_ps(lhs,rhs,_CMP_LE_OQ);}
+    static M gt(F lhs,F rhs){return _mm256_cmp_ps(lhs,rhs,_CMP_GT_OQ);}
+    static M ge(F lhs,F rhs){return _mm256_cmp_ps(lhs,rhs,_CMP_GE_OQ);}
+    static M mAnd(M lhs,M rhs){return _mm256_and_ps(lhs,rhs);}
+    static M mOr(M lhs,M rhs){return _mm256_or_ps(lhs,rhs);}
+    static F select(M mask,F lhs,F rhs){return _mm256_blendv_ps(rhs,lhs,mask);}
+    static int laneMask(M mask){return _mm256_movemask_ps(mask);}
+    static I zero(){return _mm256_setzero_si256();}
+    static I addBit(I bitmap,M mask,unsigned int bit){
+      return _mm256_or_si256(bitmap,_mm256_and_si256(_mm256_castps_si256(mask),_mm256_set1_epi32(static_cast<int>(bit))));
+    }
+    static void store(unsigned int* bitmaps,I bitmap){_mm256_storeu_si256(reinterpret_cast<__m256i*>(bitmaps),bitmap);}
+
+    static M linearLess(F lhs,F lhsScale,F xVal,F scEta,const HEEPV70Cuts::LinearCut& barrel,
+			const HEEPV70Cuts::LinearCut& endcap,double barrelCutOff,double rho){
+      const int lowBits = linearLess(lowHalf(lhs),lowHalf(lhsScale),lowHalf(xVal),lowHalf(scEta),
+				     barrel,endcap,barrelCutOff,rho);
+      const int highBits = linearLess(highHalf(lhs),highHalf(lhsScale),highHalf(xVal),highHalf(scEta),
+				      barrel,endcap,barrelCutOff,rho);
+      return fromLaneBits(lowBits|(highBits<<4));
+    }
+    static M ratioGreater(F num,F den,F scEta,double barrelMin,double endcapMin,double barrelCutOff){
+      const int lowBits = ratioGreater(lowHalf(num),lowHalf(den),lowHalf(scEta),barrelMin,endcapMin,barrelCutOff);
+      const int highBits = ratioGreater(highHalf(num),highHalf(den),highHalf(scEta),barrelMin,endcapMin,barrelCutOff);
+      return fromLaneBits(lowBits|(highBits<<4));
+    }
+  private:
+    static __m256d lowHalf(F vals){return _mm256_cvtps_pd(_mm256_castps256_ps128(vals));}
+    static __m256d highHalf(F vals){return _mm256_cvtps_pd(_mm256_extractf128_ps(vals,1));}
+    //the mask with lane N set if bit N of laneBits is
+    static M fromLaneBits(int laneBits){
+      const __m256i bitOfLane = _mm256_setr_epi32(0x1,0x2,0x4,0x8,0x10,0x20,0x40,0x80);
+      const __m256i bits = _mm256_and_si256(_mm256_set1_epi32(laneBits),bitOfLane);
+      return _mm256_castsi256_ps(_mm256_cmpeq_epi32(bits,bitOfLane));
+    }
+    static __m256d select(__m256d mask,double lhs,double rhs){
+      return _mm256_blendv_pd(_mm256_set1_pd(rhs),_mm256_set1_pd(lhs),mask);
+    }
+    //den is set to 1 where it is 0 so nothing is divided by 0 (which would trap with FP exceptions on)
+    static int ratioGreater(__m256d num,__m256d den,__m256d scEta,double barrelMin,double endcapMin,double barrelCutOff){
+      const __m256d isBarrel = _mm256_cmp_pd(_mm256_andnot_pd(_mm256_set1_pd(-0.),scEta),_mm256_set1_pd(barrelCutOff),_CMP_LT_OQ);
+      const __m256d denIsZero = _mm256_cmp_pd(den,_mm256_setzero_pd(),_CMP_EQ_OQ);
+      const __m256d ratio = _mm256_andnot_pd(denIsZero,_mm256_div_pd(num,_mm256_blendv_pd(den,_mm256_set1_pd(1.),denIsZero)));
+      return _mm256_movemask_pd(_mm256_cmp_pd(ratio,select(isBarrel,barrelMin,endcapMin),_CMP_GT_OQ));
+    }
+    static int linearLess(__m256d lhs,__m256d lhsScale,__m256d xVal,__m256d scEta,const HEEPV70Cuts::LinearCut& barrel,
+			  const HEEPV70Cuts::LinearCut& endcap,double barrelCutOff,double rho){
+      const __m256d isBarrel = _mm256_cmp_pd(_mm256_andnot_pd(_mm256_set1_pd(-0.),scEta),_mm256_set1_pd(barrelCutOff),_CMP_LT_OQ);
+      const __m256d slopeEt = _mm256_max_pd(_mm256_setzero_pd(),_mm256_sub_pd(xVal,select(isBarrel,barrel.slopeStart,endcap.slopeStart)));
+      const __m256d rhoTerm = _mm256_and_pd(_mm256_cmp_pd(xVal,select(isBarrel,barrel.rhoEtStart,endcap.rhoEtStart),_CMP_GE_OQ),
+					    _mm256_mul_pd(select(isBarrel,barrel.rhoEA,endcap.rhoEA),_mm256_set1_pd(rho)));
+      const __m256d thres = _mm256_add_pd(_mm256_add_pd(select(isBarrel,barrel.constTerm,endcap.constTerm),
+							_mm256_mul_pd(select(isBarrel,barrel.slopeTerm,endcap.slopeTerm),slopeEt)),rhoTerm);
+      return _mm256_movemask_pd(_mm256_cmp_pd(_mm256_mul_pd(lhs,lhsScale),thres,_CMP_LT_OQ));
+    }
+  };
+#endif
+}
+
+class HEEPV70SIMDEvaluator {
+private:
+  HEEPV70Cuts cuts_;
+  heepsimd::FloatCuts barrel_;
+  heepsimd::FloatCuts endcap_;
+  float minEt_;
+  float barrelCutOff_;
+  float barrelMinAbsEta_;
+  float barrelMaxAbsEta_;
+  float endcapMinAbsEta_;
+  float endcapMaxAbsEta_;
+
+public:
+  explicit HEEPV70SIMDEvaluator(const HEEPV70Cuts& cuts=HEEPV70Cuts()):
+    cuts_(cuts),barrel_(cuts.barrel),endcap_(cuts.endcap),
+    minEt_(heepsimd::ceilFloat(cuts.minEt)),
+    barrelCutOff_(heepsimd::ceilFloat(cuts.barrelCutOff)),
+    barrelMinAbsEta_(heepsimd::ceilFloat(cuts.barrelMinAbsEta)),
+    barrelMaxAbsEta_(heepsimd::floorFloat(cuts.barrelMaxAbsEta)),
+    endcapMinAbsEta_(heepsimd::ceilFloat(cuts.endcapMinAbsEta)),
+    endcapMaxAbsEta_(heepsimd::floorFloat(cuts.endcapMaxAbsEta)){}
+
+  const HEEPV70Cuts& cuts()const{return cuts_;}
+
+  //fills bitmaps (nrEles long) with the VID bitmap of each electron, rho is that of the event
+  //see above for requiredMask
+  void evaluate(const HEEPV70EleArrays& eles,size_t nrEles,double rho,unsigned int* bitmaps,
+		unsigned int requiredMask=0)const{
+    size_t eleNr=0;
+#if defined(__AVX2__)
+    for(;eleNr+heepsimd::AVX2::kNrLanes<=nrEles;eleNr+=heepsimd::AVX2::kNrLanes){
+      evaluateBlock<heepsimd::AVX2>(eles,eleNr,rho,requiredMask,bitmaps);
+    }
+#elif defined(__SSE2__)
+    for(;eleNr+heepsimd::SSE2::kNrLanes<=nrEles;eleNr+=heepsimd::SSE2::kNrLanes){
+      evaluateBlock<heepsimd::SSE2>(eles,eleNr,rho,requiredMask,bitmaps);
+    }
+#endif
+    //scalar fallback and the remainder not filling a full SIMD register
+    for(;eleNr<nrEles;eleNr++) evaluateBlock<heepsimd::Scalar>(eles,eleNr,rho,requiredMask,bitmaps);
+  }
+  std::vector<unsigned int> evaluate(const HEEPV70EleArrays& eles,size_t nrEles,double rho,
+				     unsigned int requiredMask=0)const{
+    std::vector<unsigned int> bitmaps(nrEles,0);
+    evaluate(eles,nrEles,rho,bitmaps.data(),requiredMask);
+    return bitmaps;
+  }
+
+  //does T::kNrLanes electrons starting at eleNr
+  template<typename T>
+  void evaluateBlock(const HEEPV70EleArrays& eles,size_t eleNr,double rho,unsigned int requiredMask,
+		     unsigned int* bitmaps)const{
+    using F = typename T::F;
+    using M = typename T::M;
+    using CutNrs = cutnrs::HEEPV70;
+
+    typename T::I bitmap = T::zero();
+    int passLanes = T::kAllLanes; //the lanes passing the required cuts so far
+    //adds the bit of the cut and returns if we should continue
+    auto addCut = [&](unsigned int cutNr,M pass){
+      bitmap = T::addBit(bitmap,pass,0x1<<cutNr);
+      if((requiredMask>>cutNr)&0x1) passLanes &= T::laneMask(pass);
+      return requiredMask==0 || passLanes!=0;
+    };
+
+    const F et = T::load(eles.et+eleNr);
+    const F scEta = T::load(eles.scEta+eleNr);
+    const F absEta = T::abs(scEta);
+    const M isBarrel = T::lt(absEta,T::set1(barrelCutOff_));
+    auto regionThres = [&](float barrelThres,float endcapThres){
+      return T::select(isBarrel,T::set1(barrelThres),T::set1(endcapThres));
+    };
+    const F nrSatCrys = T::load(eles.nrSatCrys+eleNr);
+    const F scEnergy = T::load(eles.scEnergy+eleNr);
+    const F e5x5 = T::load(eles.e5x5+eleNr);
+    const F one = T::set1(1.f);
+
+    //in order of cost, each addCut is only called if the previous one says to continue
+    addCut(CutNrs::ET,T::ge(et,T::set1(minEt_))) &&
+      addCut(CutNrs::ETA,T::mOr(T::mAnd(T::ge(absEta,T::set1(barrelMinAbsEta_)),T::le(absEta,T::set1(barrelMaxAbsEta_))),
+				T::mAnd(T::ge(absEta,T::set1(endcapMinAbsEta_)),T::le(absEta,T::set1(endcapMaxAbsEta_))))) &&
+      addCut(CutNrs::ECALDRIVEN,T::ge(T::load(eles.ecalDriven+eleNr),regionThres(barrel_.minEcalDriven,endcap_.minEcalDriven))) &&
+      addCut(CutNrs::MISSHITS,T::le(T::load(eles.nrMissHits+eleNr),regionThres(barrel_.maxNrMissHits,endcap_.maxNrMissHits))) &&
+      addCut(CutNrs::DETAINSEED,T::lt(T::abs(T::load(eles.dEtaInSeed+eleNr)),regionThres(barrel_.maxDEtaInSeed,endcap_.maxDEtaInSeed))) &&
+      addCut(CutNrs::DPHIIN,T::lt(T::abs(T::load(eles.dPhiIn+eleNr)),regionThres(barrel_.maxDPhiIn,endcap_.maxDPhiIn))) &&
+      addCut(CutNrs::DXY,T::lt(T::abs(T::load(eles.dxy+eleNr)),regionThres(barrel_.maxDxy,endcap_.maxDxy))) &&
+      addCut(CutNrs::SIGMAIETAIETA,T::mOr(T::gt(nrSatCrys,regionThres(barrel_.maxNrSatCrys,endcap_.maxNrSatCrys)),
+					  T::lt(T::load(eles.sigmaIEtaIEta+eleNr),regionThres(barrel_.maxSigmaIEtaIEta,endcap_.maxSigmaIEtaIEta)))) &&
+      addCut(CutNrs::E2X5OVER5X5,T::mOr(T::gt(nrSatCrys,regionThres(barrel_.maxNrSatCrys,endcap_.maxNrSatCrys)),
+					T::mOr(T::ratioGreater(T::load(eles.e1x5+eleNr),e5x5,scEta,cuts_.barrel.minE1x5OverE5x5,
+									       cuts_.endcap.minE1x5OverE5x5,cuts_.barrelCutOff),
+					       T::ratioGreater(T::load(eles.e2x5+eleNr),e5x5,scEta,cuts_.barrel.minE2x5OverE5x5,
+									       cuts_.endcap.minE2x5OverE5x5,cuts_.barrelCutOff)))) &&
+      addCut(CutNrs::TRKISO,T::linearLess(T::load(eles.trkIso+eleNr),one,et,scEta,
+					  cuts_.barrel.trkIso,cuts_.endcap.trkIso,cuts_.barrelCutOff,rho)) &&
+      addCut(CutNrs::HADEM,T::linearLess(T::load(eles.hadEm+eleNr),scEnergy,scEnergy,scEta,
+					 cuts_.barrel.hadEm,cuts_.endcap.hadEm,cuts_.barrelCutOff,rho)) &&
+      addCut(CutNrs::EMHADD1ISO,T::linearLess(T::load(eles.emHadD1Iso+eleNr),one,et,scEta,
+					      cuts_.barrel.emHadD1Iso,cuts_.endcap.emHadD1Iso,cuts_.barrelCutOff,rho));
+    T::store(bitmaps+eleNr,bitmap);
+  }
+};
+
+#endif
@@ -0,0 +1,126 @@
+#ifndef HEEP_VID_VIDBatchCutCodes_h
+#define HEEP_VID_VIDBatchCutCodes_h
+
+#include <cstddef>
+#include <vector>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#include "HEEP/VID/interface/VIDCutCodes.h"
+
+//**********************************************************
+//
+// class: VIDBatchCutCodes
+//
+// evaluates many cut masks over an array of VID bitmaps in
+// a single pass over the bitmaps
+//
+// VIDCutCodes::pass works on one bitmap and one set of cuts at a time
+// which is fine in an analyzer but for offline studies where we have
+// tens of millions of bitmaps and dozens of cut combinations it means
+// reading the bitmaps again for each combination
+//
+// both REQUIRE and IGNORE reduce to "(bitmap & mask) == mask" for a
+// suitable mask so a selection is just a single unsigned int,
+// use makeMask to build it from a list of cut numbers
+//
+// uses AVX2 or SSE2 if the compiler has it enabled, otherwise falls back
+// to plain scalar code, the results are identical in all cases
+//
+//**********************************************************
+
+template<typename BitsDef>
+class VIDBatchCutCodes {
+public:
+  using CutCodes = VIDCutCodes<BitsDef>;
+  using PassCondition = typename CutCodes::PassCondition;
+
+public:
+  VIDBatchCutCodes()=delete;
+  ~VIDBatchCutCodes()=delete;
+
+  static unsigned int makeMask(const std::vector<size_t>& bitNrs,PassCondition passCond=CutCodes::REQUIRE){
+    if(passCond==CutCodes::REQUIRE) return CutCodes::mask(bitNrs);
+    else return ( ~CutCodes::mask(bitNrs) ) & BitsDef::kFullMask;
+  }
+  static bool pass(unsigned int vidBitmap,unsigned int mask){return (vidBitmap&mask)==mask;}
+
+  //returns the number of bitmaps passing each mask
+  static std::vector<size_t> passCounts(const unsigned int* bitmaps,size_t nrBitmaps,
+					const std::vector<unsigned int>& masks){
+    std::vector<size_t> counts(masks.size(),0);
+    evaluate(bitmaps,nrBitmaps,masks,counts.data(),nullptr);
+    return counts;
+  }
+  static std::vector<size_t> passCounts(const std::vector<unsigned int>& bitmaps,
+					const std::vector<unsigned int>& masks){
+    return passCounts(bitmaps.data(),bitmaps.size(),masks);
+  }
+
+  //returns a pass flag (0=fail,1=pass) for every bitmap for each mask
+  //so result[maskNr][bitmapNr]
+  static std::vector<std::vector<unsigned char> > passFlags(const unsigned int* bitmaps,size_t nrBitmaps,
+							     const std::vector<unsigned int>& masks){
+    std::vector<std::vector<unsigned char> > flags(masks.size(),std::vector<unsigned char>(nrBitmaps,0));
+    std::vector<unsigned char*> flagPtrs;
+    for(auto& maskFlags : flags) flagPtrs.push_back(maskFlags.data());
+    std::vector<size_t> counts(masks.size(),0);
+    evaluate(bitmaps,nrBitmaps,masks,counts.data(),flagPtrs.data());
+    return flags;
+  }
+  static std::vector<std::vector<unsigned char> > passFlags(const std::vector<unsigned int>& bitmaps,
+							     const std::vector<unsigned int>& masks){
+    return passFlags(bitmaps.data(),bitmaps.size(),masks);
+  }
+
+  //the main kernel, counts must have masks.size() entries
+  //flags may be null, otherwise it has masks.size() entries each of nrBitmaps
+  static void evaluate(const unsigned int* bitmaps,size_t nrBitmaps,
+		       const std::vector<unsigned int>& masks,
+		       size_t* counts,unsigned char* const* flags){
+    const size_t nrMasks = masks.size();
+    size_t bitmapNr=0;
+    //note: the masks are broadcast inside the loop rather than stored in a
+    //std::vector<__m256i> as pre C++17 allocators dont respect their alignment
+#if defined(__AVX2__)
+    for(;bitmapNr+8<=nrBitmaps;bitmapNr+=8){
+      const __m256i vals = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bitmaps+bitmapNr));
+      for(size_t maskNr=0;maskNr<nrMasks;maskNr++){
+	const __m256i mask = _mm256_set1_epi32(static_cast<int>(masks[maskNr]));
+	const __m256i cmp = _mm256_cmpeq_epi32(_mm256_and_si256(vals,mask),mask);
+	const int passBits = _mm256_movemask_ps(_mm256_castsi256_ps(cmp));
+	counts[maskNr]+=__builtin_popcount(passBits);
+	if(flags) fillFlags(flags[maskNr]+bitmapNr,passBits,8);
+      }
+    }
+#elif defined(__SSE2__)
+    for(;bitmapNr+4<=nrBitmaps;bitmapNr+=4){
+      const __m128i vals = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bitmaps+bitmapNr));
+      for(size_t maskNr=0;maskNr<nrMasks;maskNr++){
+	const __m128i mask = _mm_set1_epi32(static_cast<int>(masks[maskNr]));
+	const __m128i cmp = _mm_cmpeq_epi32(_mm_and_si128(vals,mask),mask);
+	const int passBits = _mm_movemask_ps(_mm_castsi128_ps(cmp));
+	counts[maskNr]+=__builtin_popcount(passBits);
+	if(flags) fillFlags(flags[maskNr]+bitmapNr,passBits,4);
+      }
+    }
+#endif
+    //scalar fallback and the remainder not filling a full SIMD register
+    for(;bitmapNr<nrBitmaps;bitmapNr++){
+      for(size_t maskNr=0;maskNr<nrMasks;maskNr++){
+	const bool passed = pass(bitmaps[bitmapNr],masks[maskNr]);
+	counts[maskNr]+=passed;
+	if(flags) flags[maskNr][bitmapNr]=passed;
+      }
+    }
+  }
+
+private:
+  static void fillFlags(unsigned char* flags,int passBits,size_t nrLanes){
+    for(size_t laneNr=0;laneNr<nrLanes;laneNr++) flags[laneNr]=(passBits>>laneNr)&0x1;
+  }
+};
+
+#endif
@@ -0,0 +1,158 @@
+#ifndef HEEP_VID_VIDBitmapHist_h
+#define HEEP_VID_VIDBitmapHist_h
+
+#include <cstddef>
+#include <cstdint>
+#include <cmath>
+#include <algorithm>
+#include <vector>
+#include <istream>
+#include <ostream>
+
+#include "HEEP/VID/interface/VIDCutCodes.h"
+
+//**********************************************************
+//
+// class: VIDBitmapHist
+//
+// counts how many electrons had each possible VID bitmap
+//
+// an ID with N cuts only has 2^N possible bitmaps (4096 for HEEP V7.0)
+// so if we just count how many electrons had each bitmap, we can
+// work out the number passing any combination of cuts afterwards without
+// having to rerun the job
+//
+// fill it once per electron with the bitmap, add() merges two
+// histograms (eg from different streams)
+//
+// write() / read() save it as plain text, one line per non-empty
+// bitmap "bitmap count", so it can be queried after the job
+//
+//**********************************************************
+
+template<typename BitsDef>
+class VIDBitmapHist {
+public:
+  using CutCodes = VIDCutCodes<BitsDef>;
+  constexpr static size_t kNrCuts = BitsDef::kMaxBitNr+1;
+  constexpr static size_t kNrPatterns = BitsDef::kFullMask+1;
+
+private:
+  std::vector<uint64_t> counts_;
+
+public:
+  VIDBitmapHist():counts_(kNrPatterns,0){}
+
+  void fill(unsigned int vidBitmap,uint64_t weight=1){counts_[vidBitmap&BitsDef::kFullMask]+=weight;}
+  void add(const VIDBitmapHist& rhs){
+    for(size_t patternNr=0;patternNr<kNrPatterns;patternNr++) counts_[patternNr]+=rhs.counts_[patternNr];
+  }
+  void clear(){std::fill(counts_.begin(),counts_.end(),0);}
+
+  uint64_t count(unsigned int vidBitmap)const{return counts_[vidBitmap&BitsDef::kFullMask];}
+  uint64_t total()const{
+    uint64_t sum=0;
+    for(auto count : counts_) sum+=count;
+    return sum;
+  }
+
+  //nr of entries where all the bits in mask are set
+  //use VIDCutCodes::mask or ignoreMask to build the mask
+  uint64_t nrPassing(unsigned int mask)const{
+    uint64_t sum=0;
+    for(size_t patternNr=0;patternNr<kNrPatterns;patternNr++){
+      if((patternNr&mask)==mask) sum+=counts_[patternNr];
+    }
+    return sum;
+  }
+  uint64_t nrPassing(const std::vector<size_t>& bitNrs,typename CutCodes::PassCondition passCond=CutCodes::REQUIRE)const{
+    if(passCond==CutCodes::REQUIRE) return nrPassing(CutCodes::mask(bitNrs));
+    else return nrPassing(( ~CutCodes::mask(bitNrs) ) & BitsDef::kFullMask);
+  }
+  double eff(unsigned int mask)const{return ratio(nrPassing(mask),total());}
+
+  //the nr passing the cuts in order, ie entry N is the nr passing
+  //cuts 0 to N in cutOrder, default order is the bit order
+  std::vector<uint64_t> cutFlow(const std::vector<size_t>& cutOrder=defaultCutOrder())const{
+    std::vector<uint64_t> flow;
+    unsigned int mask=0x0;
+    for(auto bitNr : cutOrder){
+      mask|=CutCodes::mask(bitNr);
+      flow.push_back(nrPassing(mask));
+    }
+    return flow;
+  }
+
+  //nr passing all cuts except bitNr
+  uint64_t nrPassingNMinus1(size_t bitNr)const{
+    return nrPassing(( ~CutCodes::mask(bitNr) ) & BitsDef::kFullMask);
+  }
+  //eff of cut bitNr for entries passing all other cuts
+  double effNMinus1(size_t bitNr)const{
+    return ratio(nrPassing(BitsDef::kFullMask),nrPassingNMinus1(bitNr));
+  }
+
+  //nr passing both cut i and cut j, the diagonal is the nr passing cut i
+  std::vector<std::vector<uint64_t> > nrPassingMatrix()const{
+    std::vector<std::vector<uint64_t> > matrix(kNrCuts,std::vector<uint64_t>(kNrCuts,0));
+    for(size_t patternNr=0;patternNr<kNrPatterns;patternNr++){
+      if(counts_[patternNr]==0) continue;
+      for(size_t cut1=0;cut1<kNrCuts;cut1++){
+	if((patternNr&CutCodes::mask(cut1))==0) continue;
+	for(size_t cut2=0;cut2<kNrCuts;cut2++){
+	  if((patternNr&CutCodes::mask(cut2))!=0) matrix[cut1][cut2]+=counts_[patternNr];
+	}
+      }
+    }
+    return matrix;
+  }
+  //pearson correlation coefficient of the pass/fail of cut i and cut j
+  //0 if either cut always passes or always fails
+  std::vector<std::vector<double> > correlationMatrix()const{
+    const auto nrPass = nrPassingMatrix();
+    const double nrTot = total();
+    std::vector<std::vector<double> > matrix(kNrCuts,std::vector<double>(kNrCuts,0.));
+    if(nrTot==0) return matrix;
+    for(size_t cut1=0;cut1<kNrCuts;cut1++){
+      for(size_t cut2=0;cut2<kNrCuts;cut2++){
+	const double eff1 = nrPass[cut1][cut1]/nrTot;
+	const double eff2 = nrPass[cut2][cut2]/nrTot;
+	const double eff12 = nrPass[cut1][cut2]/nrTot;
+	const double var = eff1*(1-eff1)*eff2*(1-eff2);
+	matrix[cut1][cut2] = var>0 ? (eff12-eff1*eff2)/std::sqrt(var) : 0.;
+      }
+    }
+    return matrix;
+  }
+
+  void write(std::ostream& out)const{
+    for(size_t patternNr=0;patternNr<kNrPatterns;patternNr++){
+      if(counts_[patternNr]!=0) out<<patternNr<<" "<<counts_[patternNr]<<std::endl;
+    }
+  }
+  //prints the cut flow and the N-1 efficiency of each cut
+  void print(std::ostream& out)const{
+    const auto flow = cutFlow();
+    out<<"nr entries "<<total()<<std::endl;
+    for(size_t bitNr=0;bitNr<kNrCuts;bitNr++){
+      out<<"  cut "<<bitNr<<" cut flow "<<flow[bitNr]<<" N-1 eff "<<effNMinus1(bitNr)<<std::endl;
+    }
+  }
+  //adds the contents of the stream to the existing contents
+  void read(std::istream& in){
+    unsigned int pattern=0;
+    uint64_t count=0;
+    while(in>>pattern>>count) fill(pattern,count);
+  }
+
+  static std::vector<size_t> defaultCutOrder(){
+    std::vector<size_t> order;
+    for(size_t bitNr=0;bitNr<kNrCuts;bitNr++) order.push_back(bitNr);
+    return order;
+  }
+
+private:
+  static double ratio(uint64_t num,uint64_t denom){return denom!=0 ? static_cast<double>(num)/denom : 0.;}
+};
+
+#endif
@@ -1,6 +1,17 @@
 #ifndef HEEP_VID_VIDCutCodes_h
 #define HEEP_VID_VIDCutCodes_h
 
+#include <cstddef>
+#include <vector>
+
+//the runtime functions take a std::vector of cut numbers which is convenient
+//but means a heap allocation for every call
+//for the per electron loop, use the templated versions instead, eg
+//   VIDCutCodes<cutnrs::HEEPV70>::pass<ET,SIGMAIETAIETA,E2X5OVER5X5,HADEM>(bitmap)
+//   VIDCutCodes<cutnrs::HEEPV70>::passIgnoring<TRKISO>(bitmap)
+//where the mask is worked out at compile time and the bit numbers are checked
+//against BitsDef::kMaxBitNr
+//they give exactly the same results as the vector versions
 template<typename BitsDef>
 class VIDCutCodes : public BitsDef  {
 public:
@@ -13,7 +24,11 @@ public:
   
 
   static bool pass(unsigned int vidBitmap,size_t bitNr,PassCondition passCond=REQUIRE){
-    return pass(vidBitmap,std::vector<size_t>{bitNr},passCond);
+    if(passCond==REQUIRE) return (vidBitmap&mask(bitNr))!=0;
+    else{
+      unsigned int bitMask = ( ~mask(bitNr) ) & BitsDef::kFullMask;
+      return (bitMask & vidBitmap) == bitMask;
+    }
   }
   static bool pass(unsigned int vidBitmap,const std::vector<size_t>& bitNrs,PassCondition passCond=REQUIRE){
     if(passCond==REQUIRE){
@@ -34,6 +49,38 @@ public:
     for(auto bitNr : bitNrs) val|=mask(bitNr);
     return val;
   }
+  
+  //compile time versions of the above
+  template<size_t... bitNrs>
+  static constexpr unsigned int mask(){
+    static_assert(validBitNrs(bitNrs...),"VIDCutCodes: bit number is larger than BitsDef::kMaxBitNr");
+    return maskOf(bitNrs...);
+  }
+  template<size_t... bitNrs>
+  static constexpr bool pass(unsigned int vidBitmap){
+    return (vidBitmap&mask<bitNrs...>())==mask<bitNrs...>();
+  }
+  template<size_t... bitNrs>
+  static constexpr bool passIgnoring(unsigned int vidBitmap){
+    return (vidBitmap&ignoreMask<bitNrs...>())==ignoreMask<bitNrs...>();
+  }
+  template<size_t... bitNrs>
+  static constexpr unsigned int ignoreMask(){
+    return ( ~mask<bitNrs...>() ) & BitsDef::kFullMask;
+  }
+  
+private:
+  //C++14 compatible recursion rather than fold expressions
+  static constexpr unsigned int maskOf(){return 0x0;}
+  template<typename... Rest>
+  static constexpr unsigned int maskOf(size_t bitNr,Rest... rest){
+    return (0x1u << bitNr) | maskOf(rest...);
+  }
+  static constexpr bool validBitNrs(){return true;}
+  template<typename... Rest>
+  static constexpr bool validBitNrs(size_t bitNr,Rest... rest){
+    return bitNr<=BitsDef::kMaxBitNr && validBitNrs(rest...);
+  }
     
 };
 
@@ -0,0 +1,74 @@
+#ifndef HEEP_VID_VIDCutFlowView_h
+#define HEEP_VID_VIDCutFlowView_h
+
+#include <array>
+#include <cstddef>
+
+#include "HEEP/VID/interface/VIDCutCodes.h"
+
+//**********************************************************
+//
+// class: VIDCutFlowView
+//
+// a light weight copy of the pass bits and values cut upon
+// of a vid::CutFlowResult
+//
+// vid::CutFlowResult::getCutFlowResultMasking makes a new cut flow
+// result (with all its strings and vectors) each time its called
+// which is slow if you are doing N-1 for every cut on every electron
+//
+// this is made once from the vid::CutFlowResult and then answers
+// the masked, N-1 and value queries without allocating anything
+// it is indexed by the cut numbers in BitsDef (eg cutnrs::HEEPV70)
+//
+// usage:
+//   VIDCutFlowView<cutnrs::HEEPV70> heepView(*vidResult);
+//   heepView.passIgnoring(HEEPV70::TRKISO)
+//     is the same as vidResult->getCutFlowResultMasking(HEEPV70::TRKISO).cutFlowPassed()
+//
+// it only needs cutFlowBits() and getValueCutUpon() from the cut flow result
+//
+//**********************************************************
+
+template<typename BitsDef>
+class VIDCutFlowView {
+public:
+  using CutCodes = VIDCutCodes<BitsDef>;
+  constexpr static size_t kNrCuts = BitsDef::kMaxBitNr+1;
+
+private:
+  unsigned int bitmap_;
+  std::array<float,kNrCuts> values_;
+
+public:
+  VIDCutFlowView():bitmap_(0){values_.fill(0.);}
+  template<typename CutFlowResult>
+  explicit VIDCutFlowView(const CutFlowResult& cutFlowResult):
+    bitmap_(cutFlowResult.cutFlowBits()&BitsDef::kFullMask)
+  {
+    for(size_t cutNr=0;cutNr<kNrCuts;cutNr++) values_[cutNr]=cutFlowResult.getValueCutUpon(cutNr);
+  }
+
+  unsigned int bitmap()const{return bitmap_;}
+  //same as cutFlowPassed()
+  bool passed()const{return bitmap_==BitsDef::kFullMask;}
+  //same as getCutResultByIndex(cutNr)
+  bool cutResult(size_t cutNr)const{return (bitmap_&CutCodes::mask(cutNr))!=0;}
+  //same as getValueCutUpon(cutNr), note, as with the vid::CutFlowResult this
+  //is not the value actually cut on for E2x5/E5x5
+  float value(size_t cutNr)const{return values_[cutNr];}
+
+  //same as getCutFlowResultMasking(cutNr).cutFlowPassed(), ie N-1
+  bool passIgnoring(size_t cutNr)const{return CutCodes::pass(bitmap_,cutNr,CutCodes::IGNORE);}
+  //same as getCutFlowResultMasking(cutNrs).cutFlowPassed()
+  bool passIgnoringMask(unsigned int ignoreMask)const{
+    const unsigned int requireMask = ( ~ignoreMask ) & BitsDef::kFullMask;
+    return (bitmap_&requireMask)==requireMask;
+  }
+  template<size_t... bitNrs>
+  bool passIgnoring()const{return CutCodes::template passIgnoring<bitNrs...>(bitmap_);}
+  template<size_t... bitNrs>
+  bool pass()const{return CutCodes::template pass<bitNrs...>(bitmap_);}
+};
+
+#endif
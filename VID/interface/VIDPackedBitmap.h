@@ -0,0 +1,167 @@
+#ifndef HEEP_VID_VIDPackedBitmap_h
+#define HEEP_VID_VIDPackedBitmap_h
+
+#include "HEEP/VID/interface/CutNrs.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+//**********************************************************
+//
+// class: VIDPackedBitmap
+//
+// packs the VID bitmaps of several IDs into a single 64 bit word
+// so a query involving several IDs is a single AND + compare
+//
+// the IDs are given as the template arguments, each is a class
+// like those in CutNrs.h (a CutIndex enum, kMaxBitNr and kFullMask)
+// and is placed after the previous one, eg
+//   using PackedIDs = VIDPackedBitmap<cutnrs::HEEPV70,cutnrs::HEEPV60>;
+// has HEEPV70 in bits 0-11 and HEEPV60 in bits 12-23
+// the layout is worked out at compile time and it fails to compile if
+// the IDs need more than 64 bits or an ID is given twice
+//
+// each query says which ID it is for and only accepts that ID's CutIndex
+// so cutnrs::HEEPV60::TRKISO can not be used by mistake for HEEPV70
+// and the bit numbers are checked against the ID's kMaxBitNr
+//
+// usage:
+//   uint64_t packed=0;
+//   packed = PackedIDs::pack<cutnrs::HEEPV70>(packed,heepV70Bitmap);
+//   packed = PackedIDs::pack<cutnrs::HEEPV60>(packed,heepV60Bitmap);
+//
+//   //passes V7.0, passes all V6.0 cuts except TRKISO which it fails
+//   constexpr auto query = PackedIDs::pass<cutnrs::HEEPV70>() &
+//                          PackedIDs::passIgnoring<cutnrs::HEEPV60,cutnrs::HEEPV60::TRKISO>() &
+//                          PackedIDs::fail<cutnrs::HEEPV60,cutnrs::HEEPV60::TRKISO>();
+//   if(query(packed)) ...
+//
+// note: combining queries which require the same bit to both pass and fail
+// is never true, check conflicts() if building them at runtime
+//
+//**********************************************************
+
+namespace vidpacked {
+  //the bits which must be set (mask) to the values in value
+  struct Query {
+    uint64_t mask;
+    uint64_t value;
+    uint64_t conflictMask; //bits required to both pass and fail
+
+    constexpr Query(uint64_t iMask=0,uint64_t iValue=0,uint64_t iConflictMask=0):
+      mask(iMask),value(iValue),conflictMask(iConflictMask){}
+
+    constexpr bool operator()(uint64_t packed)const{return (packed&mask)==value;}
+    constexpr bool conflicts()const{return conflictMask!=0;}
+    //both queries must be true
+    constexpr Query operator&(const Query& rhs)const{
+      return Query(mask|rhs.mask,value|rhs.value,
+		   conflictMask|rhs.conflictMask|(mask&rhs.mask&(value^rhs.value)));
+    }
+  };
+
+  namespace detail {
+    template<typename ID,typename... IDs> struct Count : std::integral_constant<size_t,0>{};
+    template<typename ID,typename First,typename... Rest> struct Count<ID,First,Rest...> :
+      std::integral_constant<size_t,std::is_same<ID,First>::value + Count<ID,Rest...>::value>{};
+
+    template<typename... IDs> struct Unique : std::true_type{};
+    template<typename First,typename... Rest> struct Unique<First,Rest...> :
+      std::integral_constant<bool,Count<First,Rest...>::value==0 && Unique<Rest...>::value>{};
+
+    template<typename... IDs> struct NrBits : std::integral_constant<size_t,0>{};
+    template<typename First,typename... Rest> struct NrBits<First,Rest...> :
+      std::integral_constant<size_t,First::kMaxBitNr+1 + NrBits<Rest...>::value>{};
+
+    //the offset of ID, only meaningful if ID is in IDs
+    template<typename ID,typename... IDs> struct Offset : std::integral_constant<size_t,0>{};
+    template<typename ID,typename First,typename... Rest> struct Offset<ID,First,Rest...> :
+      std::integral_constant<size_t,std::is_same<ID,First>::value ? 0 : First::kMaxBitNr+1 + Offset<ID,Rest...>::value>{};
+  }
+}
+
+template<typename... IDs>
+class VIDPackedBitmap {
+public:
+  static constexpr size_t kNrBits = vidpacked::detail::NrBits<IDs...>::value;
+  static_assert(kNrBits<=64,"VIDPackedBitmap: the IDs need more than 64 bits");
+  static_assert(vidpacked::detail::Unique<IDs...>::value,"VIDPackedBitmap: an ID is given more than once");
+
+  using Query = vidpacked::Query;
+
+public:
+  VIDPackedBitmap()=delete;
+  ~VIDPackedBitmap()=delete;
+
+  template<typename ID>
+  static constexpr size_t offset(){
+    static_assert(vidpacked::detail::Count<ID,IDs...>::value==1,"VIDPackedBitmap: ID is not one of the packed IDs");
+    return vidpacked::detail::Offset<ID,IDs...>::value;
+  }
+  //all the bits of ID in the packed word
+  template<typename ID>
+  static constexpr uint64_t fullMask(){
+    return static_cast<uint64_t>(ID::kFullMask) << offset<ID>();
+  }
+  template<typename ID,typename ID::CutIndex... cuts>
+  static constexpr uint64_t mask(){
+    static_assert(validCuts<ID>(cuts...),"VIDPackedBitmap: cut is larger than ID::kMaxBitNr");
+    return maskOf(cuts...) << offset<ID>();
+  }
+
+  //returns packed with the bits of ID replaced by vidBitmap
+  template<typename ID>
+  static constexpr uint64_t pack(uint64_t packed,unsigned int vidBitmap){
+    return (packed & ~fullMask<ID>()) | ((static_cast<uint64_t>(vidBitmap) << offset<ID>()) & fullMask<ID>());
+  }
+  //the VID bitmap of ID
+  template<typename ID>
+  static constexpr unsigned int unpack(uint64_t packed){
+    return static_cast<unsigned int>((packed >> offset<ID>()) & ID::kFullMask);
+  }
+
+  //the queries, combine them with &
+  //passes the given cuts (all cuts of ID if none are given)
+  template<typename ID,typename ID::CutIndex... cuts>
+  static constexpr Query pass(){
+    return Query(cutsMask<ID,cuts...>(),cutsMask<ID,cuts...>());
+  }
+  //passes all cuts of ID except the given cuts
+  template<typename ID,typename ID::CutIndex... cuts>
+  static constexpr Query passIgnoring(){
+    return Query(fullMask<ID>() & ~mask<ID,cuts...>(),fullMask<ID>() & ~mask<ID,cuts...>());
+  }
+  //fails every one of the given cuts
+  template<typename ID,typename ID::CutIndex... cuts>
+  static constexpr Query fail(){
+    static_assert(sizeof...(cuts)!=0,"VIDPackedBitmap: fail needs at least one cut");
+    return Query(mask<ID,cuts...>(),0);
+  }
+
+private:
+  template<typename ID,typename ID::CutIndex... cuts>
+  static constexpr uint64_t cutsMask(){
+    return sizeof...(cuts)==0 ? fullMask<ID>() : mask<ID,cuts...>();
+  }
+
+  //C++14 compatible recursion rather than fold expressions
+  static constexpr uint64_t maskOf(){return 0x0;}
+  template<typename Cut,typename... Rest>
+  static constexpr uint64_t maskOf(Cut cut,Rest... rest){
+    return (static_cast<uint64_t>(0x1) << cut) | maskOf(rest...);
+  }
+  template<typename ID>
+  static constexpr bool validCuts(){return true;}
+  template<typename ID,typename Cut,typename... Rest>
+  static constexpr bool validCuts(Cut cut,Rest... rest){
+    return static_cast<unsigned int>(cut)<=ID::kMaxBitNr && validCuts<ID>(rest...);
+  }
+};
+
+//the HEEP IDs and the cut based working points we usually run
+using HEEPPackedIDs = VIDPackedBitmap<cutnrs::HEEPV70,cutnrs::HEEPV60,
+				      cutnrs::CutBasedV2Veto,cutnrs::CutBasedV2Loose,
+				      cutnrs::CutBasedV2Medium,cutnrs::CutBasedV2Tight>;
+
+#endif
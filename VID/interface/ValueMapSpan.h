@@ -0,0 +1,65 @@
+#ifndef HEEP_VID_ValueMapSpan_h
+#define HEEP_VID_ValueMapSpan_h
+
+#include "DataFormats/Common/interface/ValueMap.h"
+#include "DataFormats/Provenance/interface/ProductID.h"
+#include "FWCore/Utilities/interface/Exception.h"
+
+#include <cstddef>
+#include <vector>
+
+//**********************************************************
+//
+// class: ValueMapSpan
+//
+// the values of a edm::ValueMap for a single collection, indexed by
+// the position of the object in that collection
+//
+// (*valueMap)[elePtr] finds the product ID of the electron in the
+// value map and then works out the offset each time its called
+// however a value map stores the values of each collection contiguously
+// so we can find the offset once per event and then just index it,
+// ie span[eleNr] is (*valueMap)[edm::Ptr<Ele>(eleHandle,eleNr)]
+//
+// this is only valid while the value map is (ie for the event)
+//
+// usage:
+//   ValueMapSpan<float> trkIsos(*trkIsoMap,eleHandle.id(),eleHandle->size());
+//   for(size_t eleNr=0;eleNr<eleHandle->size();eleNr++){
+//     float trkIso = trkIsos[eleNr];
+//
+//**********************************************************
+
+template<typename T>
+class ValueMapSpan {
+public:
+  using const_iterator = typename std::vector<T>::const_iterator;
+  using const_reference = typename std::vector<T>::const_reference;
+
+private:
+  const_iterator begin_;
+  size_t size_;
+
+public:
+  ValueMapSpan():begin_(),size_(0){}
+  //throws if the value map doesnt have the collection or has fewer values than nrObjs
+  ValueMapSpan(const edm::ValueMap<T>& valueMap,edm::ProductID collId,size_t nrObjs):
+    begin_(),size_(0)
+  {
+    for(auto it=valueMap.begin();it!=valueMap.end();++it){
+      if(it.id()==collId){
+	begin_ = it.begin();
+	size_ = it.size();
+	break;
+      }
+    }
+    if(size_<nrObjs){
+      throw cms::Exception("ValueMapSpan") <<"value map has "<<size_<<" values for product "<<collId<<" but the collection has "<<nrObjs<<" objects";
+    }
+  }
+
+  size_t size()const{return size_;}
+  const_reference operator[](size_t objNr)const{return begin_[objNr];}
+};
+
+#endif
@@ -0,0 +1,264 @@
+#include "FWCore/Utilities/interface/InputTag.h"
+#include "FWCore/Utilities/interface/EDGetToken.h"
+#include "FWCore/Utilities/interface/Exception.h"
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/Run.h"
+#include "FWCore/Framework/interface/EventSetup.h"
+#include "FWCore/Framework/interface/ESHandle.h"
+#include "FWCore/Framework/interface/stream/EDProducer.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "DataFormats/EgammaCandidates/interface/GsfElectron.h"
+#include "DataFormats/EgammaReco/interface/SuperCluster.h"
+#include "DataFormats/EcalDetId/interface/EBDetId.h"
+#include "DataFormats/EcalDetId/interface/EEDetId.h"
+#include "DataFormats/EcalRecHit/interface/EcalRecHitCollections.h"
+#include "Geometry/CaloTopology/interface/CaloTopology.h"
+#include "Geometry/Records/interface/CaloTopologyRecord.h"
+#include "RecoCaloTools/Navigation/interface/CaloNavigator.h"
+#include "FWCore/Framework/interface/MakerMacros.h"
+#include "DataFormats/Common/interface/ValueMap.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+//**********************************************************
+//
+// class: HEEPNrSatCrysProducer
+//
+// counts the saturated crystals in a NxN window around the seed crystal
+// of each electron and puts it as a edm::ValueMap<int>, the 5x5 window
+// is the same as heepIDVarValueMaps:eleNrSaturateIn5x5
+// (ie noZS::EcalClusterTools::nrSaturatedCrysIn5x5)
+//
+// rather than walking the topology and looking up each crystal in the
+// rec hits for every electron, at the start of the run the crystals of
+// the largest window around every EB and EE crystal are written to a
+// table (using the topology exactly as EcalClusterTools::matrixDetId
+// does) and each event the saturated rec hits are set in a bitset
+// so counting an electron is NxN table reads and bit tests
+//
+// the crystal index is the EB hashed index or the EE hashed index plus
+// the nr of EB crystals, crystals outside the detector have the index
+// kNrCrys, which is never set
+//
+// the table is shared by all the streams and only remade when the
+// calo topology changes
+//
+// the window sizes are given by windowSizes (odd), each is put with
+// the label "eleNrSaturateIn<N>x<N>"
+//
+//**********************************************************
+
+namespace{
+  class CrysWindowTable {
+  public:
+    static constexpr uint32_t kNrEBCrys = EBDetId::kSizeForDenseIndexing;
+    static constexpr uint32_t kNrCrys = kNrEBCrys+EEDetId::kSizeForDenseIndexing;
+
+  private:
+    int windowSize_;
+    std::vector<uint32_t> table_; //[crysIndex*windowSize_*windowSize_ + etaOffset*windowSize_ + phiOffset]
+
+  public:
+    CrysWindowTable(const CaloTopology& topology,int windowSize);
+
+    int windowSize()const{return windowSize_;}
+    //the first crystal of the window around crysIndex, the rows are windowSize() long
+    const uint32_t* window(uint32_t crysIndex)const{return &table_[crysIndex*windowSize_*windowSize_];}
+
+    static uint32_t crysIndex(DetId id){
+      if(id.det()!=DetId::Ecal) return kNrCrys;
+      if(id.subdetId()==EcalBarrel) return EBDetId(id).hashedIndex();
+      if(id.subdetId()==EcalEndcap) return kNrEBCrys+EEDetId(id).hashedIndex();
+      return kNrCrys;
+    }
+
+  private:
+    void fill(const CaloTopology& topology,DetId id);
+  };
+
+  struct GlobalData {
+    explicit GlobalData(const edm::ParameterSet& iPara):maxWindowSize(1),topologyCacheId(0){
+      for(auto windowSize : iPara.getParameter<std::vector<unsigned int> >("windowSizes")){
+	if(windowSize%2==0) throw cms::Exception("Configuration") <<"HEEPNrSatCrysProducer: window size "<<windowSize<<" is not odd";
+	maxWindowSize = std::max(maxWindowSize,static_cast<int>(windowSize));
+      }
+    }
+    int maxWindowSize;
+    mutable std::mutex mutex;
+    mutable unsigned long long topologyCacheId;
+    mutable std::shared_ptr<const CrysWindowTable> crysWindowTable;
+  };
+}
+
+CrysWindowTable::CrysWindowTable(const CaloTopology& topology,int windowSize):
+  windowSize_(windowSize),
+  table_(static_cast<size_t>(kNrCrys)*windowSize*windowSize,static_cast<uint32_t>(kNrCrys))
+{
+  for(int hashNr=0;hashNr<EBDetId::kSizeForDenseIndexing;hashNr++) fill(topology,EBDetId::unhashIndex(hashNr));
+  for(int hashNr=0;hashNr<EEDetId::kSizeForDenseIndexing;hashNr++) fill(topology,EEDetId::unhashIndex(hashNr));
+}
+
+void CrysWindowTable::fill(const CaloTopology& topology,DetId id)
+{
+  const int halfSize = windowSize_/2;
+  uint32_t* window = &table_[crysIndex(id)*windowSize_*windowSize_];
+  CaloNavigator<DetId> cursor(id,topology.getSubdetectorTopology(id));
+  for(int etaOffset=-halfSize;etaOffset<=halfSize;etaOffset++){
+    for(int phiOffset=-halfSize;phiOffset<=halfSize;phiOffset++){
+      cursor.home();
+      cursor.offsetBy(etaOffset,phiOffset);
+      if(*cursor!=DetId(0)) window[(etaOffset+halfSize)*windowSize_+phiOffset+halfSize] = crysIndex(*cursor);
+    }
+  }
+}
+
+class HEEPNrSatCrysProducer : public edm::stream::EDProducer<edm::GlobalCache<GlobalData>,
+							     edm::RunCache<CrysWindowTable> > {
+
+private:
+  edm::EDGetTokenT<edm::View<reco::GsfElectron> > eleAODToken_;
+  edm::EDGetTokenT<edm::View<reco::GsfElectron> > eleMiniAODToken_;
+  edm::EDGetTokenT<EcalRecHitCollection> ebRecHitAODToken_;
+  edm::EDGetTokenT<EcalRecHitCollection> eeRecHitAODToken_;
+  edm::EDGetTokenT<EcalRecHitCollection> ebRecHitMiniAODToken_;
+  edm::EDGetTokenT<EcalRecHitCollection> eeRecHitMiniAODToken_;
+
+  std::vector<int> windowSizes_;
+  std::vector<std::string> labels_;
+
+  //the saturated crystals of the event, satCrysIndices_ is so only they need resetting
+  std::vector<uint64_t> satCrysBits_;
+  std::vector<uint32_t> satCrysIndices_;
+
+public:
+  explicit HEEPNrSatCrysProducer(const edm::ParameterSet& iPara,const GlobalData*);
+  virtual ~HEEPNrSatCrysProducer(){}
+
+  static std::unique_ptr<GlobalData> initializeGlobalCache(const edm::ParameterSet& iPara) {
+    return std::make_unique<GlobalData>(iPara);
+  }
+  static void globalEndJob(const GlobalData*){}
+  static std::shared_ptr<CrysWindowTable> globalBeginRun(const edm::Run&,const edm::EventSetup& iSetup,const RunContext* iContext);
+  static void globalEndRun(const edm::Run&,const edm::EventSetup&,const RunContext*){}
+
+private:
+  void produce(edm::Event& iEvent,const edm::EventSetup& iSetup) override;
+  void setSatCrys(const EcalRecHitCollection& recHits);
+  void clearSatCrys();
+  bool isSatCrys(uint32_t crysIndex)const{return (satCrysBits_[crysIndex>>6]>>(crysIndex&0x3F))&0x1;}
+  int nrSatCrys(const uint32_t* window,int maxWindowSize,int windowSize)const;
+};
+
+HEEPNrSatCrysProducer::HEEPNrSatCrysProducer(const edm::ParameterSet& iPara,const GlobalData*):
+  satCrysBits_(CrysWindowTable::kNrCrys/64+1,0)
+{
+  eleAODToken_=consumes<edm::View<reco::GsfElectron> >(iPara.getParameter<edm::InputTag>("elesAOD"));
+  eleMiniAODToken_=consumes<edm::View<reco::GsfElectron> >(iPara.getParameter<edm::InputTag>("elesMiniAOD"));
+  ebRecHitAODToken_=consumes<EcalRecHitCollection>(iPara.getParameter<edm::InputTag>("ebRecHitsAOD"));
+  eeRecHitAODToken_=consumes<EcalRecHitCollection>(iPara.getParameter<edm::InputTag>("eeRecHitsAOD"));
+  ebRecHitMiniAODToken_=consumes<EcalRecHitCollection>(iPara.getParameter<edm::InputTag>("ebRecHitsMiniAOD"));
+  eeRecHitMiniAODToken_=consumes<EcalRecHitCollection>(iPara.getParameter<edm::InputTag>("eeRecHitsMiniAOD"));
+
+  for(auto windowSize : iPara.getParameter<std::vector<unsigned int> >("windowSizes")){
+    windowSizes_.push_back(windowSize);
+    labels_.push_back("eleNrSaturateIn"+std::to_string(windowSize)+"x"+std::to_string(windowSize));
+    produces<edm::ValueMap<int> >(labels_.back());
+  }
+}
+
+//the table takes O(100ms) to make so it is reused if the topology hasnt changed
+std::shared_ptr<CrysWindowTable> HEEPNrSatCrysProducer::globalBeginRun(const edm::Run&,const edm::EventSetup& iSetup,const RunContext* iContext)
+{
+  const GlobalData* globalData = iContext->global();
+  const CaloTopologyRecord& topologyRecord = iSetup.get<CaloTopologyRecord>();
+
+  std::lock_guard<std::mutex> lock(globalData->mutex);
+  if(!globalData->crysWindowTable || globalData->topologyCacheId!=topologyRecord.cacheIdentifier()){
+    edm::ESHandle<CaloTopology> topologyHandle;
+    topologyRecord.get(topologyHandle);
+    globalData->crysWindowTable = std::make_shared<const CrysWindowTable>(*topologyHandle,globalData->maxWindowSize);
+    globalData->topologyCacheId = topologyRecord.cacheIdentifier();
+  }
+  //the run cache is non-const but is only ever read
+  return std::const_pointer_cast<CrysWindowTable>(globalData->crysWindowTable);
+}
+
+void HEEPNrSatCrysProducer::setSatCrys(const EcalRecHitCollection& recHits)
+{
+  for(auto& hit : recHits){
+    if(hit.checkFlag(EcalRecHit::kSaturated)){
+      const uint32_t crysIndex = CrysWindowTable::crysIndex(hit.id());
+      if(crysIndex==CrysWindowTable::kNrCrys) continue;
+      satCrysBits_[crysIndex>>6] |= uint64_t(0x1)<<(crysIndex&0x3F);
+      satCrysIndices_.push_back(crysIndex);
+    }
+  }
+}
+
+void HEEPNrSatCrysProducer::clearSatCrys()
+{
+  for(auto crysIndex : satCrysIndices_) satCrysBits_[crysIndex>>6] = 0;
+  satCrysIndices_.clear();
+}
+
+//the window is centred in the table window so the smaller windows are a sub block of it
+int HEEPNrSatCrysProducer::nrSatCrys(const uint32_t* window,int maxWindowSize,int windowSize)const
+{
+  const int offset = (maxWindowSize-windowSize)/2;
+  int nrSat=0;
+  for(int etaNr=offset;etaNr<offset+windowSize;etaNr++){
+    const uint32_t* row = window+etaNr*maxWindowSize+offset;
+    for(int phiNr=0;phiNr<windowSize;phiNr++) nrSat+=isSatCrys(row[phiNr]);
+  }
+  return nrSat;
+}
+
+//we dont know if we have miniAOD or AOD, try the AOD electrons first
+//and use the miniAOD electrons and rec hits if they are not present
+void HEEPNrSatCrysProducer::produce(edm::Event& iEvent,const edm::EventSetup& iSetup)
+{
+  edm::Handle<edm::View<reco::GsfElectron> > eleHandle;
+  iEvent.getByToken(eleAODToken_,eleHandle);
+  const bool isAOD = eleHandle.isValid();
+  if(!isAOD) iEvent.getByToken(eleMiniAODToken_,eleHandle);
+
+  //nrSatCryses[windowNr][eleNr]
+  std::vector<std::vector<int> > nrSatCryses(windowSizes_.size(),std::vector<int>(eleHandle->size(),0));
+  if(!eleHandle->empty()){
+    edm::Handle<EcalRecHitCollection> ebRecHitHandle;
+    edm::Handle<EcalRecHitCollection> eeRecHitHandle;
+    iEvent.getByToken(isAOD ? ebRecHitAODToken_ : ebRecHitMiniAODToken_,ebRecHitHandle);
+    iEvent.getByToken(isAOD ? eeRecHitAODToken_ : eeRecHitMiniAODToken_,eeRecHitHandle);
+    setSatCrys(*ebRecHitHandle);
+    setSatCrys(*eeRecHitHandle);
+
+    //if nothing is saturated, which is almost always, the counts are all zero
+    if(!satCrysIndices_.empty()){
+      const CrysWindowTable& table = *runCache();
+      for(size_t eleNr=0;eleNr<eleHandle->size();eleNr++){
+	const uint32_t seedIndex = CrysWindowTable::crysIndex((*eleHandle)[eleNr].superCluster()->seed()->seed());
+	if(seedIndex==CrysWindowTable::kNrCrys) continue;
+	const uint32_t* window = table.window(seedIndex);
+	for(size_t windowNr=0;windowNr<windowSizes_.size();windowNr++){
+	  nrSatCryses[windowNr][eleNr] = nrSatCrys(window,table.windowSize(),windowSizes_[windowNr]);
+	}
+      }
+      clearSatCrys();
+    }
+  }
+
+  for(size_t windowNr=0;windowNr<windowSizes_.size();windowNr++){
+    auto nrSatCrysMap = std::make_unique<edm::ValueMap<int> >();
+    edm::ValueMap<int>::Filler filler(*nrSatCrysMap);
+    filler.insert(eleHandle,nrSatCryses[windowNr].begin(),nrSatCryses[windowNr].end());
+    filler.fill();
+    iEvent.put(std::move(nrSatCrysMap),labels_[windowNr]);
+  }
+}
+
+DEFINE_FWK_MODULE(HEEPNrSatCrysProducer);
@@ -0,0 +1,271 @@
+#include "FWCore/Utilities/interface/InputTag.h"
+#include "FWCore/Utilities/interface/EDGetToken.h"
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/stream/EDProducer.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "DataFormats/EgammaCandidates/interface/GsfElectron.h"
+#include "DataFormats/GsfTrackReco/interface/GsfTrack.h"
+#include "DataFormats/TrackReco/interface/Track.h"
+#include "DataFormats/PatCandidates/interface/PackedCandidate.h"
+#include "DataFormats/Math/interface/deltaR.h"
+#include "FWCore/Framework/interface/MakerMacros.h"
+#include "DataFormats/Common/interface/ValueMap.h"
+
+#include "HEEP/VID/interface/HEEPEtaPhiGrid.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+//**********************************************************
+//
+// class: HEEPTrkIsoProducer
+//
+// calculates the HEEP tracker isolation for several cone sizes
+// and vetos at once and puts each as a edm::ValueMap<float>
+//
+// the isolation is the same as EleTkIsolFromCands (as used by
+// heepIDVarValueMaps for eleTrkPtIso) without the track quality / algo
+// requirements which HEEP V7.0 does not use, ie the sum of the pt of tracks with
+//   minDR <= dR <= maxDR, |dEta| >= minDEta, |dZ| < maxDZ, pt > minPt,
+//   nr valid hits >= minHits, nr valid pixel hits >= minPixelHits
+//   and ptError/pt < maxDPtPt (if maxDPtPt >= 0)
+// where the electron position is that of its gsf track and the
+// barrel (|eta|<1.5) or endcap cuts are used depending on its eta
+//
+// the tracks are binned in eta/phi once per event (see HEEPEtaPhiGrid.h)
+// so for each electron only the nearby tracks are looked at, and each
+// track is checked against all the cones at once
+//
+// so the nominal cone gives exactly the same float as eleTrkPtIso, the
+// selection is done in the same precision as EleTkIsolFromCands and the pts
+// are summed in double in the order of the candidates, each collection
+// separately, before being added to the float isolation as
+// heepIDVarValueMaps does, electrons without a gsf track get the max float
+// and missing candidate collections are skipped as they are there
+//
+// the tracks are the charged packed candidates with track details of
+// candsAOD or candsMiniAOD (depending on which electrons are present), the
+// cfi takes these from heepIDVarValueMaps so eleTrkPtIso sums the same tracks
+// (on AOD the packed candidates made for it, not generalTracks)
+//
+// each cone is written with its label, with the nominal HEEP V7.0 cone
+// labeled "eleTrkPtIso" so it is meant to be usable for trkIsoMap in place of
+// heepIDVarValueMaps:eleTrkPtIso (see heepTrkIsoProducer_cfi.py), the agreement
+// has not been measured yet, check it with heepV70Example_cfg.py useHEEPTrkIsoProducer=True
+// (vidTrkIsoMismatch in the job summary must be 0) before relying on it
+//
+//**********************************************************
+
+class HEEPTrkIsoProducer : public edm::stream::EDProducer<> {
+
+private:
+  struct TrkCuts {
+    explicit TrkCuts(const edm::ParameterSet& iPara):
+      minPt(iPara.getParameter<double>("minPt")),
+      maxDZ(iPara.getParameter<double>("maxDZ")),
+      minHits(iPara.getParameter<int>("minHits")),
+      minPixelHits(iPara.getParameter<int>("minPixelHits")),
+      maxDPtPt(iPara.getParameter<double>("maxDPtPt")){}
+    float minPt;
+    float maxDZ;
+    int minHits;
+    int minPixelHits;
+    float maxDPtPt;
+  };
+  struct Cone {
+    explicit Cone(const edm::ParameterSet& iPara):
+      label(iPara.getParameter<std::string>("label")),
+      minDR2(std::pow(iPara.getParameter<double>("minDR"),2)),
+      maxDR2(std::pow(iPara.getParameter<double>("maxDR"),2)),
+      minDEta(iPara.getParameter<double>("minDEta")){}
+    std::string label;
+    float minDR2;
+    float maxDR2;
+    float minDEta;
+  };
+  //the tracks of the event, stored as columns in the precision reco::Track has them
+  //the tracks are in the order of the candidates, collection by collection
+  struct Trks {
+    std::vector<double> etas;
+    std::vector<double> phis;
+    std::vector<double> pts;
+    std::vector<double> vzs;
+    std::vector<double> ptErrors;
+    std::vector<int> nrHits;
+    std::vector<int> nrPixelHits;
+    std::vector<unsigned int> collNrs;
+
+    void clear();
+    void add(const reco::Track& trk,unsigned int collNr);
+  };
+
+  edm::EDGetTokenT<edm::View<reco::GsfElectron> > eleAODToken_;
+  edm::EDGetTokenT<edm::View<reco::GsfElectron> > eleMiniAODToken_;
+  std::vector<edm::EDGetTokenT<edm::View<pat::PackedCandidate> > > candsAODTokens_;
+  std::vector<edm::EDGetTokenT<edm::View<pat::PackedCandidate> > > candsMiniAODTokens_;
+
+  TrkCuts barrelCuts_;
+  TrkCuts endcapCuts_;
+  std::vector<Cone> cones_;
+
+  Trks trks_;
+  HEEPEtaPhiGrid trkGrid_;
+  std::vector<unsigned int> eleTrkNrs_; //the tracks passing the cuts of the current electron
+
+  static constexpr float kBarrelMaxEta=1.5;
+
+public:
+  explicit HEEPTrkIsoProducer(const edm::ParameterSet& iPara);
+  virtual ~HEEPTrkIsoProducer(){}
+
+private:
+  void produce(edm::Event& iEvent,const edm::EventSetup& iSetup) override;
+  void fillTrks(const edm::Event& iEvent,bool isAOD);
+  float calIsol(const reco::GsfElectron& ele,const Cone& cone)const;
+  static float maxConeSize(const std::vector<edm::ParameterSet>& cones);
+};
+
+void HEEPTrkIsoProducer::Trks::clear()
+{
+  etas.clear();
+  phis.clear();
+  pts.clear();
+  vzs.clear();
+  ptErrors.clear();
+  nrHits.clear();
+  nrPixelHits.clear();
+  collNrs.clear();
+}
+
+void HEEPTrkIsoProducer::Trks::add(const reco::Track& trk,unsigned int collNr)
+{
+  etas.push_back(trk.eta());
+  phis.push_back(trk.phi());
+  pts.push_back(trk.pt());
+  vzs.push_back(trk.vz());
+  ptErrors.push_back(trk.ptError());
+  nrHits.push_back(trk.hitPattern().numberOfValidHits());
+  nrPixelHits.push_back(trk.hitPattern().numberOfValidPixelHits());
+  collNrs.push_back(collNr);
+}
+
+HEEPTrkIsoProducer::HEEPTrkIsoProducer(const edm::ParameterSet& iPara):
+  barrelCuts_(iPara.getParameter<edm::ParameterSet>("barrelCuts")),
+  endcapCuts_(iPara.getParameter<edm::ParameterSet>("endcapCuts")),
+  //a little larger than the largest cone so a track at its edge is never lost to the float eta/phi of the grid
+  trkGrid_(maxConeSize(iPara.getParameter<std::vector<edm::ParameterSet> >("cones"))*1.001f)
+{
+  eleAODToken_=consumes<edm::View<reco::GsfElectron> >(iPara.getParameter<edm::InputTag>("elesAOD"));
+  eleMiniAODToken_=consumes<edm::View<reco::GsfElectron> >(iPara.getParameter<edm::InputTag>("elesMiniAOD"));
+  for(auto& tag : iPara.getParameter<std::vector<edm::InputTag> >("candsAOD")){
+    candsAODTokens_.push_back(consumes<edm::View<pat::PackedCandidate> >(tag));
+  }
+  for(auto& tag : iPara.getParameter<std::vector<edm::InputTag> >("candsMiniAOD")){
+    candsMiniAODTokens_.push_back(consumes<edm::View<pat::PackedCandidate> >(tag));
+  }
+  for(auto& conePara : iPara.getParameter<std::vector<edm::ParameterSet> >("cones")){
+    cones_.emplace_back(conePara);
+    produces<edm::ValueMap<float> >(cones_.back().label);
+  }
+}
+
+float HEEPTrkIsoProducer::maxConeSize(const std::vector<edm::ParameterSet>& cones)
+{
+  float maxDR=0.;
+  for(auto& cone : cones) maxDR = std::max(maxDR,static_cast<float>(cone.getParameter<double>("maxDR")));
+  return maxDR;
+}
+
+//AOD or miniAOD is decided by which electrons are present, as for heepIDVarValueMaps
+void HEEPTrkIsoProducer::fillTrks(const edm::Event& iEvent,bool isAOD)
+{
+  trks_.clear();
+  const auto& tokens = isAOD ? candsAODTokens_ : candsMiniAODTokens_;
+  for(unsigned int collNr=0;collNr<tokens.size();collNr++){
+    edm::Handle<edm::View<pat::PackedCandidate> > candsHandle;
+    iEvent.getByToken(tokens[collNr],candsHandle);
+    if(!candsHandle.isValid()) continue; //as heepIDVarValueMaps
+    for(auto& cand : *candsHandle){
+      if(cand.charge()!=0 && cand.hasTrackDetails()) trks_.add(cand.pseudoTrack(),collNr);
+    }
+  }
+  trkGrid_.build(trks_.etas,trks_.phis);
+}
+
+void HEEPTrkIsoProducer::produce(edm::Event& iEvent,const edm::EventSetup& iSetup)
+{
+  edm::Handle<edm::View<reco::GsfElectron> > eleHandle;
+  iEvent.getByToken(eleAODToken_,eleHandle);
+  const bool isAOD = eleHandle.isValid();
+  if(!isAOD) iEvent.getByToken(eleMiniAODToken_,eleHandle);
+
+  if(!eleHandle->empty()) fillTrks(iEvent,isAOD);
+
+  //isols[coneNr][eleNr]
+  std::vector<std::vector<float> > isols(cones_.size(),std::vector<float>(eleHandle->size(),0.));
+  for(size_t eleNr=0;eleNr<eleHandle->size();eleNr++){
+    const reco::GsfElectron& ele = (*eleHandle)[eleNr];
+    if(ele.gsfTrack().isNull()){
+      for(auto& coneIsols : isols) coneIsols[eleNr] = std::numeric_limits<float>::max();
+      continue;
+    }
+    const reco::GsfTrack& eleTrk = *ele.gsfTrack();
+    const double eleEta = eleTrk.eta();
+    const double eleVZ = eleTrk.vz();
+    const TrkCuts& cuts = std::abs(eleEta)<kBarrelMaxEta ? barrelCuts_ : endcapCuts_;
+
+    //the tracks passing the cut not depending on the cone, sorted back into candidate order
+    eleTrkNrs_.clear();
+    trkGrid_.forEachNear(eleEta,eleTrk.phi(),[&](size_t trkNr){
+	const float dZ = eleVZ-trks_.vzs[trkNr];
+	const double trkPt = trks_.pts[trkNr];
+	if(std::abs(dZ)<cuts.maxDZ &&
+	   trks_.nrHits[trkNr]>=cuts.minHits &&
+	   trks_.nrPixelHits[trkNr]>=cuts.minPixelHits &&
+	   (trks_.ptErrors[trkNr]/trkPt<cuts.maxDPtPt || cuts.maxDPtPt<0) &&
+	   trkPt>cuts.minPt) eleTrkNrs_.push_back(trkNr);
+      });
+    std::sort(eleTrkNrs_.begin(),eleTrkNrs_.end());
+
+    for(size_t coneNr=0;coneNr<cones_.size();coneNr++){
+      isols[coneNr][eleNr] = calIsol(ele,cones_[coneNr]);
+    }
+  }
+
+  for(size_t coneNr=0;coneNr<cones_.size();coneNr++){
+    auto isolMap = std::make_unique<edm::ValueMap<float> >();
+    edm::ValueMap<float>::Filler filler(*isolMap);
+    filler.insert(eleHandle,isols[coneNr].begin(),isols[coneNr].end());
+    filler.fill();
+    iEvent.put(std::move(isolMap),cones_[coneNr].label);
+  }
+}
+
+//sums the pts of the tracks in eleTrkNrs_ in the cone
+//in double for each collection and adds them to the float isolation, as heepIDVarValueMaps
+float HEEPTrkIsoProducer::calIsol(const reco::GsfElectron& ele,const Cone& cone)const
+{
+  const double eleEta = ele.gsfTrack()->eta();
+  const double elePhi = ele.gsfTrack()->phi();
+  float isol=0.;
+  double collPtSum=0.;
+  unsigned int collNr=0;
+  for(auto trkNr : eleTrkNrs_){
+    if(trks_.collNrs[trkNr]!=collNr){
+      isol+=collPtSum;
+      collPtSum=0.;
+      collNr=trks_.collNrs[trkNr];
+    }
+    const float dR2 = reco::deltaR2(eleEta,elePhi,trks_.etas[trkNr],trks_.phis[trkNr]);
+    const float dEta = trks_.etas[trkNr]-eleEta;
+    if(dR2>=cone.minDR2 && dR2<=cone.maxDR2 && std::abs(dEta)>=cone.minDEta) collPtSum+=trks_.pts[trkNr];
+  }
+  isol+=collPtSum;
+  return isol;
+}
+
+DEFINE_FWK_MODULE(HEEPTrkIsoProducer);
@@ -0,0 +1,147 @@
+#include "FWCore/Utilities/interface/InputTag.h"
+#include "FWCore/Utilities/interface/EDGetToken.h"
+#include "FWCore/Utilities/interface/Exception.h"
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/one/EDAnalyzer.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "DataFormats/Common/interface/Ptr.h"
+#include "DataFormats/EgammaCandidates/interface/GsfElectron.h"
+#include "FWCore/Framework/interface/MakerMacros.h"
+#include "DataFormats/Common/interface/ValueMap.h"
+#include "DataFormats/PatCandidates/interface/VIDCutFlowResult.h"
+
+#include "HEEP/VID/interface/CutNrs.h"
+#include "HEEP/VID/interface/HEEPColumnarFormat.h"
+
+#include <memory>
+
+//**********************************************************
+//
+// class: HEEPV70ColumnarWriter
+//
+// writes the HEEP V7.0 information of every electron to a
+// simple columnar binary file (see HEEPColumnarFormat.h) which
+// can be memory mapped by HEEPColumnarReader.h outside of CMSSW
+//
+// its much faster to scan than a "keep *" EDM file for HEEP studies
+// where all we need is a handful of variables per electron
+//
+// there is one row per electron with the columns
+//   run, lumi, event, eleNr, et, eta, phi, bitmap, trkIso, nrSatCrys
+//   and val_<CUT> for each cut in cutnrs::HEEPV70, the value cut upon
+//   (as with getValueCutUpon, E2X5OVER5X5 is not the value actually cut on)
+//
+// its a one module as it writes a single file
+//
+//**********************************************************
+
+class HEEPV70ColumnarWriter : public edm::one::EDAnalyzer<> {
+
+private:
+  edm::EDGetTokenT<edm::View<reco::GsfElectron> > eleAODToken_;
+  edm::EDGetTokenT<edm::View<reco::GsfElectron> > eleMiniAODToken_;
+  edm::EDGetTokenT<edm::ValueMap<unsigned int> > vidBitmapToken_;
+  edm::EDGetTokenT<edm::ValueMap<vid::CutFlowResult> > vidResultToken_;
+  edm::EDGetTokenT<edm::ValueMap<int> > nrSatCrysMapToken_;
+  edm::EDGetTokenT<edm::ValueMap<float> > trkIsoMapToken_;
+
+  std::string outputFile_;
+  size_t rowGroupSize_;
+  std::unique_ptr<heepcol::Writer> writer_;
+
+  enum ColIndex {
+    RUN=0,LUMI,EVENT,ELENR,ET,ETA,PHI,BITMAP,TRKISO,NRSATCRYS,FIRSTVAL
+  };
+
+public:
+  explicit HEEPV70ColumnarWriter(const edm::ParameterSet& iPara);
+  virtual ~HEEPV70ColumnarWriter(){}
+
+private:
+  void beginJob() override;
+  void analyze(const edm::Event& iEvent,const edm::EventSetup& iSetup) override;
+  void endJob() override;
+};
+
+HEEPV70ColumnarWriter::HEEPV70ColumnarWriter(const edm::ParameterSet& iPara):
+  outputFile_(iPara.getUntrackedParameter<std::string>("outputFile")),
+  rowGroupSize_(iPara.getUntrackedParameter<unsigned int>("rowGroupSize",65536))
+{
+  eleAODToken_=consumes<edm::View<reco::GsfElectron> >(iPara.getParameter<edm::InputTag>("elesAOD"));
+  eleMiniAODToken_=consumes<edm::View<reco::GsfElectron> >(iPara.getParameter<edm::InputTag>("elesMiniAOD"));
+  vidBitmapToken_=consumes<edm::ValueMap<unsigned int> >(iPara.getParameter<edm::InputTag>("vidBitmap"));
+  vidResultToken_=consumes<edm::ValueMap<vid::CutFlowResult> >(iPara.getParameter<edm::InputTag>("vid"));
+  nrSatCrysMapToken_=consumes<edm::ValueMap<int> >(iPara.getParameter<edm::InputTag>("nrSatCrysMap"));
+  trkIsoMapToken_=consumes<edm::ValueMap<float> >(iPara.getParameter<edm::InputTag>("trkIsoMap"));
+}
+
+void HEEPV70ColumnarWriter::beginJob()
+{
+  using heepcol::ColType;
+  using heepcol::makeColDesc;
+  //must be in the same order as ColIndex
+  std::vector<heepcol::ColDesc> cols = {
+    makeColDesc("run",ColType::UINT32),
+    makeColDesc("lumi",ColType::UINT32),
+    makeColDesc("event",ColType::UINT64),
+    makeColDesc("eleNr",ColType::UINT32),
+    makeColDesc("et",ColType::FLOAT),
+    makeColDesc("eta",ColType::FLOAT),
+    makeColDesc("phi",ColType::FLOAT),
+    makeColDesc("bitmap",ColType::UINT32),
+    makeColDesc("trkIso",ColType::FLOAT),
+    makeColDesc("nrSatCrys",ColType::INT32)
+  };
+  for(unsigned int cutNr=0;cutNr<=cutnrs::HEEPV70::kMaxBitNr;cutNr++){
+    cols.push_back(makeColDesc(std::string("val_")+cutnrs::HEEPV70::name(cutNr),ColType::FLOAT));
+  }
+  writer_ = std::make_unique<heepcol::Writer>(outputFile_,cols,rowGroupSize_);
+}
+
+void HEEPV70ColumnarWriter::analyze(const edm::Event& iEvent,const edm::EventSetup& iSetup)
+{
+  edm::Handle<edm::View<reco::GsfElectron> > eleHandle;
+  edm::Handle<edm::ValueMap<unsigned int> > vidBitmap;
+  edm::Handle<edm::ValueMap<vid::CutFlowResult> > vidResult;
+  edm::Handle<edm::ValueMap<int> > nrSatCrysMap;
+  edm::Handle<edm::ValueMap<float> > trkIsoMap;
+
+  iEvent.getByToken(eleAODToken_,eleHandle);
+  if(!eleHandle.isValid()) iEvent.getByToken(eleMiniAODToken_,eleHandle);
+  iEvent.getByToken(vidBitmapToken_,vidBitmap);
+  iEvent.getByToken(vidResultToken_,vidResult);
+  iEvent.getByToken(nrSatCrysMapToken_,nrSatCrysMap);
+  iEvent.getByToken(trkIsoMapToken_,trkIsoMap);
+
+  for(size_t eleNr=0;eleNr<eleHandle->size();eleNr++){
+    edm::Ptr<reco::GsfElectron> elePtr(eleHandle,eleNr);
+    const vid::CutFlowResult& heepCutFlowResult = (*vidResult)[elePtr];
+
+    writer_->fill<uint32_t>(RUN,iEvent.id().run());
+    writer_->fill<uint32_t>(LUMI,iEvent.luminosityBlock());
+    writer_->fill<uint64_t>(EVENT,iEvent.id().event());
+    writer_->fill<uint32_t>(ELENR,eleNr);
+    writer_->fill<float>(ET,elePtr->et());
+    writer_->fill<float>(ETA,elePtr->eta());
+    writer_->fill<float>(PHI,elePtr->phi());
+    writer_->fill<uint32_t>(BITMAP,(*vidBitmap)[elePtr]);
+    writer_->fill<float>(TRKISO,(*trkIsoMap)[elePtr]);
+    writer_->fill<int32_t>(NRSATCRYS,(*nrSatCrysMap)[elePtr]);
+    for(unsigned int cutNr=0;cutNr<=cutnrs::HEEPV70::kMaxBitNr;cutNr++){
+      writer_->fill<float>(FIRSTVAL+cutNr,heepCutFlowResult.getValueCutUpon(cutNr));
+    }
+    writer_->endRow();
+  }
+}
+
+void HEEPV70ColumnarWriter::endJob()
+{
+  //closing here rather than in the destructor so a file which could not be written fails the job
+  try{
+    if(writer_) writer_->close();
+  }catch(std::runtime_error& e){
+    throw cms::Exception("HEEPV70ColumnarWriter") <<"error writing "<<outputFile_<<": "<<e.what();
+  }
+}
+
+DEFINE_FWK_MODULE(HEEPV70ColumnarWriter);
@@ -0,0 +1,159 @@
+#include "FWCore/Utilities/interface/InputTag.h"
+#include "FWCore/Utilities/interface/EDGetToken.h"
+#include "FWCore/Utilities/interface/Exception.h"
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/stream/EDProducer.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "DataFormats/Common/interface/Ptr.h"
+#include "DataFormats/PatCandidates/interface/Electron.h"
+#include "FWCore/Framework/interface/MakerMacros.h"
+#include "DataFormats/Common/interface/ValueMap.h"
+#include "DataFormats/PatCandidates/interface/VIDCutFlowResult.h"
+
+#include "HEEP/VID/interface/HEEPV70CompactResult.h"
+
+//**********************************************************
+//
+// class: HEEPV70ElectronEmbedder
+//
+// makes a new pat::Electron collection with the HEEP V7.0
+// information embeded as user data
+//
+// this does the same as the five EGExtraInfoModifiers in
+// heepV70Modifier_cfi.py but in a single pass over the electrons,
+// reading all the value maps once per event rather than each
+// modifier reading its own, and only copying the electrons once
+//
+// it adds (in the same order as the modifiers)
+//   userFloat("trkPtIso")
+//   userInt("nrSatCrys")
+//   userInt("heepElectronID_HEEPV70")
+//   userInt("heepElectronID_HEEPV70Bitmap")
+//   userData<vid::CutFlowResult>("heepElectronID_HEEPV70")
+//
+// optionally, it can also embed a HEEPV70CompactResult (the bitmap
+// and values cut upon without the names) as
+//   userData<HEEPV70CompactResult>(compactVIDResultLabel)
+// with compactVIDResultMantissaBits of precision for the values
+// and setting embedFullVIDResult to false drops the vid::CutFlowResult
+// which makes the electrons noticeably smaller, likewise embedVIDPass false
+// drops the pass userInt
+//
+// any of trkIsoMap, nrSatCrysMap, vid and vidBitmap can be an empty
+// InputTag in which case that information is not read or embeded,
+// so if it is made unscheduled the producers of it are not run
+// (vid empty means neither the pass userInt nor the vid::CutFlowResult)
+//
+// use addHEEPV70ElesMiniAOD(process,useFusedEmbedder=True) in tools.py to
+// use this rather than the modifiers
+//
+//**********************************************************
+
+class HEEPV70ElectronEmbedder : public edm::stream::EDProducer<> {
+
+private:
+  edm::EDGetTokenT<edm::View<pat::Electron> > elesToken_;
+  edm::EDGetTokenT<edm::ValueMap<float> > trkIsoMapToken_;
+  edm::EDGetTokenT<edm::ValueMap<int> > nrSatCrysMapToken_;
+  edm::EDGetTokenT<edm::ValueMap<bool> > vidPassToken_;
+  edm::EDGetTokenT<edm::ValueMap<unsigned int> > vidBitmapToken_;
+  edm::EDGetTokenT<edm::ValueMap<vid::CutFlowResult> > vidResultToken_;
+
+  std::string trkIsoLabel_;
+  std::string nrSatCrysLabel_;
+  std::string vidPassLabel_;
+  std::string vidBitmapLabel_;
+  std::string vidResultLabel_;
+  bool embedVIDPass_;
+  bool embedFullVIDResult_;
+  std::string compactVIDResultLabel_; //empty = dont embed
+  unsigned int compactVIDResultMantissaBits_;
+
+public:
+  explicit HEEPV70ElectronEmbedder(const edm::ParameterSet& iPara);
+  virtual ~HEEPV70ElectronEmbedder(){}
+
+private:
+  void produce(edm::Event& iEvent,const edm::EventSetup& iSetup) override;
+};
+
+HEEPV70ElectronEmbedder::HEEPV70ElectronEmbedder(const edm::ParameterSet& iPara):
+  trkIsoLabel_(iPara.getParameter<std::string>("trkIsoLabel")),
+  nrSatCrysLabel_(iPara.getParameter<std::string>("nrSatCrysLabel")),
+  vidPassLabel_(iPara.getParameter<std::string>("vidLabel")),
+  vidBitmapLabel_(iPara.getParameter<std::string>("vidBitmapLabel")),
+  vidResultLabel_(iPara.getParameter<std::string>("vidLabel")),
+  embedVIDPass_(iPara.getParameter<bool>("embedVIDPass")),
+  embedFullVIDResult_(iPara.getParameter<bool>("embedFullVIDResult")),
+  compactVIDResultLabel_(iPara.getParameter<std::string>("compactVIDResultLabel")),
+  compactVIDResultMantissaBits_(iPara.getParameter<unsigned int>("compactVIDResultMantissaBits"))
+{
+  elesToken_=consumes<edm::View<pat::Electron> >(iPara.getParameter<edm::InputTag>("eles"));
+  const edm::InputTag trkIsoMapTag = iPara.getParameter<edm::InputTag>("trkIsoMap");
+  const edm::InputTag nrSatCrysMapTag = iPara.getParameter<edm::InputTag>("nrSatCrysMap");
+  const edm::InputTag vidTag = iPara.getParameter<edm::InputTag>("vid");
+  const edm::InputTag vidBitmapTag = iPara.getParameter<edm::InputTag>("vidBitmap");
+  if(!trkIsoMapTag.label().empty()) trkIsoMapToken_=consumes<edm::ValueMap<float> >(trkIsoMapTag);
+  if(!nrSatCrysMapTag.label().empty()) nrSatCrysMapToken_=consumes<edm::ValueMap<int> >(nrSatCrysMapTag);
+  if(!vidBitmapTag.label().empty()) vidBitmapToken_=consumes<edm::ValueMap<unsigned int> >(vidBitmapTag);
+  if(!vidTag.label().empty()){
+    if(embedVIDPass_) vidPassToken_=consumes<edm::ValueMap<bool> >(vidTag);
+    if(embedFullVIDResult_ || !compactVIDResultLabel_.empty()){
+      vidResultToken_=consumes<edm::ValueMap<vid::CutFlowResult> >(vidTag);
+    }
+  }else if(!compactVIDResultLabel_.empty()){
+    throw cms::Exception("Configuration") <<"HEEPV70ElectronEmbedder: compactVIDResultLabel is set but vid is empty";
+  }
+
+  produces<std::vector<pat::Electron> >();
+}
+
+void HEEPV70ElectronEmbedder::produce(edm::Event& iEvent,const edm::EventSetup& iSetup)
+{
+  edm::Handle<edm::View<pat::Electron> > elesHandle;
+  edm::Handle<edm::ValueMap<float> > trkIsoMap;
+  edm::Handle<edm::ValueMap<int> > nrSatCrysMap;
+  edm::Handle<edm::ValueMap<bool> > vidPass;
+  edm::Handle<edm::ValueMap<unsigned int> > vidBitmap;
+  edm::Handle<edm::ValueMap<vid::CutFlowResult> > vidResult;
+
+  //the tokens of the empty InputTags are uninitialized and not read
+  iEvent.getByToken(elesToken_,elesHandle);
+  if(!trkIsoMapToken_.isUninitialized()) iEvent.getByToken(trkIsoMapToken_,trkIsoMap);
+  if(!nrSatCrysMapToken_.isUninitialized()) iEvent.getByToken(nrSatCrysMapToken_,nrSatCrysMap);
+  if(!vidPassToken_.isUninitialized()) iEvent.getByToken(vidPassToken_,vidPass);
+  if(!vidBitmapToken_.isUninitialized()) iEvent.getByToken(vidBitmapToken_,vidBitmap);
+  if(!vidResultToken_.isUninitialized()) iEvent.getByToken(vidResultToken_,vidResult);
+
+  auto outEles = std::make_unique<std::vector<pat::Electron> >();
+  outEles->reserve(elesHandle->size());
+
+  //what is embeded is decided by which tokens are set, not which handles are valid,
+  //so a configured product which is missing still throws when dereferenced
+  const bool embedTrkIso = !trkIsoMapToken_.isUninitialized();
+  const bool embedNrSatCrys = !nrSatCrysMapToken_.isUninitialized();
+  const bool embedVIDPass = !vidPassToken_.isUninitialized();
+  const bool embedVIDBitmap = !vidBitmapToken_.isUninitialized();
+  const bool embedVIDResult = embedFullVIDResult_ && !vidResultToken_.isUninitialized();
+  const bool embedCompactVIDResult = !compactVIDResultLabel_.empty();
+
+  for(size_t eleNr=0;eleNr<elesHandle->size();eleNr++){
+    edm::Ptr<pat::Electron> elePtr(elesHandle,eleNr);
+    outEles->push_back((*elesHandle)[eleNr]);
+    pat::Electron& ele = outEles->back();
+
+    //the modifiers convert bool and unsigned int to int in the same way
+    if(embedTrkIso) ele.addUserFloat(trkIsoLabel_,(*trkIsoMap)[elePtr]);
+    if(embedNrSatCrys) ele.addUserInt(nrSatCrysLabel_,(*nrSatCrysMap)[elePtr]);
+    if(embedVIDPass) ele.addUserInt(vidPassLabel_,static_cast<int>((*vidPass)[elePtr]));
+    if(embedVIDBitmap) ele.addUserInt(vidBitmapLabel_,static_cast<int>((*vidBitmap)[elePtr]));
+    if(embedVIDResult) ele.addUserData(vidResultLabel_,(*vidResult)[elePtr]);
+    if(embedCompactVIDResult){
+      ele.addUserData(compactVIDResultLabel_,HEEPV70CompactResult((*vidResult)[elePtr],compactVIDResultMantissaBits_));
+    }
+  }
+
+  iEvent.put(std::move(outEles));
+}
+
+DEFINE_FWK_MODULE(HEEPV70ElectronEmbedder);
@@ -1,11 +1,16 @@
 #include "FWCore/Utilities/interface/InputTag.h"
 #include "FWCore/Utilities/interface/EDGetToken.h"
 #include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/Run.h"
+#include "FWCore/Framework/interface/LuminosityBlock.h"
 #include "FWCore/Framework/interface/stream/EDAnalyzer.h"
 #include "FWCore/ParameterSet/interface/ParameterSet.h"
 #include "DataFormats/Common/interface/Ptr.h"
 #include "DataFormats/PatCandidates/interface/Electron.h"
 #include "DataFormats/EgammaCandidates/interface/GsfElectron.h"
+#include "DataFormats/EgammaReco/interface/SuperCluster.h"
+#include "DataFormats/GsfTrackReco/interface/GsfTrack.h"
+#include "DataFormats/VertexReco/interface/Vertex.h"
 #include "FWCore/Framework/interface/MakerMacros.h"
 #include "DataFormats/Common/interface/ValueMap.h"
 #include "DataFormats/PatCandidates/interface/VIDCutFlowResult.h"
@@ -19,6 +24,20 @@
 //useful
 #include "HEEP/VID/interface/CutNrs.h"
 #include "HEEP/VID/interface/VIDCutCodes.h"
+#include "HEEP/VID/interface/VIDBitmapHist.h"
+#include "HEEP/VID/interface/VIDCutFlowView.h"
+#include "HEEP/VID/interface/HEEPTimingStats.h"
+#include "HEEP/VID/interface/HEEPDiagnostics.h"
+#include "HEEP/VID/interface/ValueMapSpan.h"
+#include "HEEP/VID/interface/HEEPV70SIMDEvaluator.h"
+
+#include <fstream>
+#include <limits>
+#include <mutex>
+#include <memory>
+#include <cstdint>
+#include <string>
+#include <vector>
 
 //**********************************************************
 //
@@ -62,18 +81,75 @@
 //a struct to count the number of electrons passing/failing
 //see https://twiki.cern.ch/twiki/bin/view/CMSPublic/FWMultithreadedFrameworkStreamModuleInterface
 //if you dont understand why I'm doing this
+//each stream counts its own electrons so nothing is shared in the per electron loop
+//these are then added together per lumi section and run using the summary caches
+//and per job in the global cache
+//its aligned to a cache line so the counters of different streams never share one
 namespace{
-  struct NrPassFail {
+  struct alignas(64) NrPassFail {
     NrPassFail():nrPass(0),nrFail(0){}
-    mutable std::atomic<int> nrPass;
-    mutable std::atomic<int> nrFail;
+    uint64_t nrPass;
+    uint64_t nrFail;
+    
+    void add(const NrPassFail& rhs){nrPass+=rhs.nrPass;nrFail+=rhs.nrFail;}
+    void clear(){nrPass=0;nrFail=0;}
+    uint64_t nrTot()const{return nrPass+nrFail;}
+    double passRate()const{return nrTot()!=0 ? static_cast<double>(nrPass)/nrTot() : 0.;}
+  };
+  //the categories of the messages of the per electron loop, see HEEPDiagnostics.h
+  enum DiagCat {DIAG_NRSATCRYS=0,DIAG_VIDPASS,DIAG_VIDTRKISO,DIAG_VIDSHOWERSHAPECUTS,DIAG_VIDTRKISOCUTS,DIAG_TRKISON1,DIAG_VALUEMAPSPAN,DIAG_SIMDBITMAP};
+  const std::vector<std::string> kDiagCatNames={"nrSatCrys","vidPassMismatch","vidTrkIsoMismatch","vidShowerShapeCutsMismatch",
+						"vidTrkIsoCutsMismatch","trkIsoN1Fail","valueMapSpanMismatch","simdBitmapMismatch"};
+
+  //the variables HEEPV70SIMDEvaluator needs as columns, kept between events so they are not reallocated
+  struct SIMDEleColumns {
+    std::vector<float> et,scEta,scEnergy,dEtaInSeed,dPhiIn,sigmaIEtaIEta,e1x5,e2x5,e5x5,hadEm,trkIso,emHadD1Iso,dxy;
+    std::vector<int> nrMissHits,ecalDriven,nrSatCrys;
+    std::vector<unsigned int> bitmaps;
+
+    void fill(const edm::View<reco::GsfElectron>& eles,const ValueMapSpan<float>& trkIsos,
+	      const ValueMapSpan<int>& nrSatCryses,const reco::VertexCollection& vertices);
+    HEEPV70EleArrays arrays()const{
+      return {et.data(),scEta.data(),scEnergy.data(),dEtaInSeed.data(),dPhiIn.data(),sigmaIEtaIEta.data(),
+	  e1x5.data(),e2x5.data(),e5x5.data(),hadEm.data(),trkIso.data(),emHadD1Iso.data(),dxy.data(),
+	  nrMissHits.data(),ecalDriven.data(),nrSatCrys.data()};
+    }
+  };
+
+  //the job wide data, the bitmap histogram counts how many electrons had
+  //each bitmap so we can work out the efficiency of any cut combination
+  //after the job (optionally written to bitmapHistFile)
+  //each stream fills its own histogram which is added to this one at the end of the stream
+  //if timingFile is set, each stream also times its events and the timings of all
+  //streams are written there as json at the end of the job, see HEEPTimingStats.h
+  struct GlobalData {
+    explicit GlobalData(const edm::ParameterSet& iPara):
+      bitmapHistFile(iPara.getUntrackedParameter<std::string>("bitmapHistFile","")),
+      timingFile(iPara.getUntrackedParameter<std::string>("timingFile","")),
+      diagnostics(kDiagCatNames){}
+    std::string bitmapHistFile;
+    std::string timingFile;
+    mutable std::mutex mutex;
+    mutable NrPassFail nrPassFail;
+    mutable VIDBitmapHist<cutnrs::HEEPV70> bitmapHist;
+    mutable std::vector<HEEPTimingStats> timingStats;
+    mutable HEEPDiagnostics diagnostics;
   };
 }
 
-class HEEPV70Example : public edm::stream::EDAnalyzer<edm::GlobalCache<NrPassFail>> {
+class HEEPV70Example : public edm::stream::EDAnalyzer<edm::GlobalCache<GlobalData>,
+								       edm::RunSummaryCache<NrPassFail>,
+								       edm::LuminosityBlockSummaryCache<NrPassFail> > {
 
 private:
  
+  NrPassFail nrPassFailRun_;
+  NrPassFail nrPassFailLumi_;
+  VIDBitmapHist<cutnrs::HEEPV70> bitmapHist_;
+  HEEPTimingStats timing_;
+  //the messages of the per electron loop are buffered here and written at the end of the lumi
+  HEEPDiagnostics diag_;
+
   edm::EDGetTokenT<edm::View<reco::GsfElectron> > eleAODToken_;
   edm::EDGetTokenT<edm::View<reco::GsfElectron> > eleMiniAODToken_;
   edm::EDGetTokenT<edm::ValueMap<bool> > vidPassToken_;
@@ -84,22 +160,61 @@ private:
   edm::EDGetTokenT<edm::ValueMap<int> > nrSatCrysMapToken_; 
   edm::EDGetTokenT<edm::ValueMap<float> > trkIsoMapToken_; 
 
+  //if true, checks every value read via the ValueMapSpans against
+  //the value read via the edm::Ptr, for debugging
+  bool checkValueMapSpans_;
+
+  //if true, recalculates the bitmaps with HEEPV70SIMDEvaluator from the
+  //electrons and checks they are the same as VID's, for validating it
+  bool checkSIMDEvaluator_;
+  edm::EDGetTokenT<double> rhoToken_;
+  edm::EDGetTokenT<reco::VertexCollection> verticesAODToken_;
+  edm::EDGetTokenT<reco::VertexCollection> verticesMiniAODToken_;
+  HEEPV70SIMDEvaluator simdEvaluator_;
+  SIMDEleColumns simdEleColumns_;
   
 public:
-  explicit HEEPV70Example(const edm::ParameterSet& iPara,const NrPassFail*);
+  explicit HEEPV70Example(const edm::ParameterSet& iPara,const GlobalData*);
   virtual ~HEEPV70Example(){}
   
-  static std::unique_ptr<NrPassFail> initializeGlobalCache(const edm::ParameterSet&) {
-    return std::make_unique<NrPassFail>();
+  static std::unique_ptr<GlobalData> initializeGlobalCache(const edm::ParameterSet& iPara) {
+    return std::make_unique<GlobalData>(iPara);
   }
   void analyze(const edm::Event& iEvent,const edm::EventSetup& iSetup) override;
-  static void globalEndJob(const NrPassFail* nrPassFail) {
-    std::cout <<"nr eles pass "<<nrPassFail->nrPass<<" / "<<nrPassFail->nrPass+nrPassFail->nrFail<<std::endl;
+  void endStream() override;
+  static void globalEndJob(const GlobalData* globalData);
+
+  void checkSIMDBitmaps(const edm::Event& iEvent,const edm::Handle<edm::View<reco::GsfElectron> >& eleHandle,bool isAOD,
+			const ValueMapSpan<unsigned int>& vidBitmaps,const ValueMapSpan<float>& trkIsos,
+			const ValueMapSpan<int>& nrSatCryses);
+
+  void beginRun(const edm::Run&,const edm::EventSetup&) override{nrPassFailRun_.clear();}
+  static std::shared_ptr<NrPassFail> globalBeginRunSummary(const edm::Run&,const edm::EventSetup&,const RunContext*){
+    return std::make_shared<NrPassFail>();
+  }
+  void endRunSummary(const edm::Run&,const edm::EventSetup&,NrPassFail* runNrPassFail)const override{
+    runNrPassFail->add(nrPassFailRun_);
   }
+  static void globalEndRunSummary(const edm::Run& iRun,const edm::EventSetup&,const RunContext* iContext,NrPassFail* runNrPassFail);
+ 
+  void beginLuminosityBlock(const edm::LuminosityBlock&,const edm::EventSetup&) override{nrPassFailLumi_.clear();}
+  void endLuminosityBlock(const edm::LuminosityBlock& iLumi,const edm::EventSetup&) override;
+  static std::shared_ptr<NrPassFail> globalBeginLuminosityBlockSummary(const edm::LuminosityBlock&,const edm::EventSetup&,const LuminosityBlockContext*){
+    return std::make_shared<NrPassFail>();
+  }
+  void endLuminosityBlockSummary(const edm::LuminosityBlock&,const edm::EventSetup&,NrPassFail* lumiNrPassFail)const override{
+    lumiNrPassFail->add(nrPassFailLumi_);
+  }
+  static void globalEndLuminosityBlockSummary(const edm::LuminosityBlock& iLumi,const edm::EventSetup&,const LuminosityBlockContext*,NrPassFail* lumiNrPassFail);
 };
   
 
-HEEPV70Example::HEEPV70Example(const edm::ParameterSet& iPara,const NrPassFail*)
+HEEPV70Example::HEEPV70Example(const edm::ParameterSet& iPara,const GlobalData* globalData):
+  timing_(!globalData->timingFile.empty()),
+  diag_(kDiagCatNames,iPara.getUntrackedParameter<unsigned int>("maxDiagMsgsPerLumi",10),
+	iPara.getUntrackedParameter<unsigned int>("diagSampleEvery",0)),
+  checkValueMapSpans_(iPara.getUntrackedParameter<bool>("checkValueMapSpans",false)),
+  checkSIMDEvaluator_(iPara.getUntrackedParameter<bool>("checkSIMDEvaluator",false))
 {
   //the sharp eyed amoungst you will notice I use the "vid" tag twice
   //this is because VID products have the same label (just different types)
@@ -111,12 +226,74 @@ HEEPV70Example::HEEPV70Example(const edm::ParameterSet& iPara,const NrPassFail*)
   vidResultToken_=consumes<edm::ValueMap<vid::CutFlowResult> >(iPara.getParameter<edm::InputTag>("vid"));
   nrSatCrysMapToken_=consumes<edm::ValueMap<int> >(iPara.getParameter<edm::InputTag>("nrSatCrysMap"));
   trkIsoMapToken_=consumes<edm::ValueMap<float> >(iPara.getParameter<edm::InputTag>("trkIsoMap"));
-  
+  if(checkSIMDEvaluator_){
+    rhoToken_=consumes<double>(iPara.getUntrackedParameter<edm::InputTag>("rho",edm::InputTag("fixedGridRhoFastjetAll")));
+    verticesAODToken_=consumes<reco::VertexCollection>(iPara.getUntrackedParameter<edm::InputTag>("verticesAOD",edm::InputTag("offlinePrimaryVertices")));
+    verticesMiniAODToken_=consumes<reco::VertexCollection>(iPara.getUntrackedParameter<edm::InputTag>("verticesMiniAOD",edm::InputTag("offlineSlimmedPrimaryVertices")));
+  }
+}
+
+//the variables as the VID cuts calculate them
+void SIMDEleColumns::fill(const edm::View<reco::GsfElectron>& eles,const ValueMapSpan<float>& trkIsos,
+			  const ValueMapSpan<int>& nrSatCryses,const reco::VertexCollection& vertices)
+{
+  for(auto* column : {&et,&scEta,&scEnergy,&dEtaInSeed,&dPhiIn,&sigmaIEtaIEta,&e1x5,&e2x5,&e5x5,&hadEm,&trkIso,&emHadD1Iso,&dxy}){
+    column->clear();
+  }
+  for(auto* column : {&nrMissHits,&ecalDriven,&nrSatCrys}) column->clear();
+
+  for(size_t eleNr=0;eleNr<eles.size();eleNr++){
+    const reco::GsfElectron& ele = eles[eleNr];
+    const reco::SuperClusterRef& sc = ele.superCluster();
+    const bool hasSC = sc.isNonnull();
+    et.push_back(ele.pt());
+    //without a supercluster the electron fails the eta cut, as it does dEtaInSeed in VID
+    scEta.push_back(hasSC ? sc->eta() : std::numeric_limits<float>::max());
+    scEnergy.push_back(hasSC ? sc->energy() : 0.);
+    dEtaInSeed.push_back(hasSC && sc->seed().isNonnull() ?
+			 ele.deltaEtaSuperClusterTrackAtVtx() - sc->eta() + sc->seed()->eta() :
+			 std::numeric_limits<float>::max());
+    dPhiIn.push_back(ele.deltaPhiSuperClusterTrackAtVtx());
+    sigmaIEtaIEta.push_back(ele.full5x5_sigmaIetaIeta());
+    e1x5.push_back(ele.full5x5_e1x5());
+    e2x5.push_back(ele.full5x5_e2x5Max());
+    e5x5.push_back(ele.full5x5_e5x5());
+    hadEm.push_back(ele.hadronicOverEm());
+    trkIso.push_back(trkIsos[eleNr]);
+    emHadD1Iso.push_back(ele.dr03EcalRecHitSumEt()+ele.dr03HcalDepth1TowerSumEt());
+    dxy.push_back(vertices.empty() ? ele.gsfTrack()->dxy() : ele.gsfTrack()->dxy(vertices.front().position()));
+    nrMissHits.push_back(ele.gsfTrack()->hitPattern().numberOfLostHits(reco::HitPattern::MISSING_INNER_HITS));
+    ecalDriven.push_back(ele.ecalDriven()); //ecalDrivenSeed() && passingCutBasedPreselection() as GsfEleEcalDrivenCut
+    nrSatCrys.push_back(nrSatCryses[eleNr]);
+  }
+  bitmaps.resize(eles.size());
+}
+
+void HEEPV70Example::checkSIMDBitmaps(const edm::Event& iEvent,const edm::Handle<edm::View<reco::GsfElectron> >& eleHandle,bool isAOD,
+				      const ValueMapSpan<unsigned int>& vidBitmaps,const ValueMapSpan<float>& trkIsos,
+				      const ValueMapSpan<int>& nrSatCryses)
+{
+  edm::Handle<double> rhoHandle;
+  edm::Handle<reco::VertexCollection> verticesHandle;
+  iEvent.getByToken(rhoToken_,rhoHandle);
+  iEvent.getByToken(isAOD ? verticesAODToken_ : verticesMiniAODToken_,verticesHandle);
+
+  simdEleColumns_.fill(*eleHandle,trkIsos,nrSatCryses,*verticesHandle);
+  simdEvaluator_.evaluate(simdEleColumns_.arrays(),eleHandle->size(),*rhoHandle,simdEleColumns_.bitmaps.data());
+  for(size_t eleNr=0;eleNr<eleHandle->size();eleNr++){
+    if(simdEleColumns_.bitmaps[eleNr]!=vidBitmaps[eleNr]){
+      if(auto out = diag_.message(DIAG_SIMDBITMAP)){
+	*out <<"HEEPV70SIMDEvaluator bitmap "<<std::hex<<simdEleColumns_.bitmaps[eleNr]
+	     <<" VID "<<vidBitmaps[eleNr]<<std::dec<<" for ele "<<eleNr<<std::endl;
+      }
+    }
+  }
 }
 
 
 void HEEPV70Example::analyze(const edm::Event& iEvent,const edm::EventSetup& iSetup)
 {
+  auto startTime = timing_.now();
   edm::Handle<edm::View<reco::GsfElectron> > eleHandle;
 
   edm::Handle<edm::ValueMap<bool> > vidPass;
@@ -129,7 +306,8 @@ void HEEPV70Example::analyze(const edm::Event& iEvent,const edm::EventSetup& iSe
   //we done know if we have miniAOD or AOD, try both, AOD first and get
   //miniAOD if AOD not present
   iEvent.getByToken(eleAODToken_,eleHandle);
-  if(!eleHandle.isValid()) iEvent.getByToken(eleMiniAODToken_,eleHandle);
+  const bool isAOD = eleHandle.isValid();
+  if(!isAOD) iEvent.getByToken(eleMiniAODToken_,eleHandle);
   
 
   iEvent.getByToken(vidPassToken_,vidPass);
@@ -138,21 +316,45 @@ void HEEPV70Example::analyze(const edm::Event& iEvent,const edm::EventSetup& iSe
   iEvent.getByToken(trkIsoMapToken_,trkIsoMap);
   iEvent.getByToken(nrSatCrysMapToken_,nrSatCrysMap);
 
-  for(size_t eleNr=0;eleNr<eleHandle->size();eleNr++){  
-    edm::Ptr<reco::GsfElectron> elePtr(eleHandle,eleNr); //note we use an edm::Ptr rather than an edm::Ref
-                                                         //as we do not know if its a pat::Electron 
-                                                         //or a reco::GsfElectron
+  //(*vidPass)[elePtr] would find the offset of the electrons in the value map for every electron
+  //so instead we find it once per event for each value map, then index them by electron number
+  //see ValueMapSpan.h
+  const size_t nrEles = eleHandle->size();
+  const ValueMapSpan<bool> vidPassSpan(*vidPass,eleHandle.id(),nrEles);
+  const ValueMapSpan<unsigned int> vidBitmapSpan(*vidBitmap,eleHandle.id(),nrEles);
+  const ValueMapSpan<vid::CutFlowResult> vidResultSpan(*vidResult,eleHandle.id(),nrEles);
+  const ValueMapSpan<int> nrSatCrysSpan(*nrSatCrysMap,eleHandle.id(),nrEles);
+  const ValueMapSpan<float> trkIsoSpan(*trkIsoMap,eleHandle.id(),nrEles);
+  auto fetchedTime = timing_.now();
+
+  if(checkSIMDEvaluator_) checkSIMDBitmaps(iEvent,eleHandle,isAOD,vidBitmapSpan,trkIsoSpan,nrSatCrysSpan);
+
+  for(size_t eleNr=0;eleNr<nrEles;eleNr++){  
+    if(checkValueMapSpans_){
+      edm::Ptr<reco::GsfElectron> elePtr(eleHandle,eleNr); //note we use an edm::Ptr rather than an edm::Ref
+                                                           //as we do not know if its a pat::Electron 
+                                                           //or a reco::GsfElectron
+      if(vidPassSpan[eleNr]!=(*vidPass)[elePtr] ||
+	 vidBitmapSpan[eleNr]!=(*vidBitmap)[elePtr] ||
+	 &vidResultSpan[eleNr]!=&(*vidResult)[elePtr] ||
+	 nrSatCrysSpan[eleNr]!=(*nrSatCrysMap)[elePtr] ||
+	 trkIsoSpan[eleNr]!=(*trkIsoMap)[elePtr]){
+	if(auto out = diag_.message(DIAG_VALUEMAPSPAN)) *out <<"error in ValueMapSpan for ele "<<eleNr<<std::endl;
+      }
+    }
    
     //this allows to tell if the electron passed HEEPV70, true = passed
-    bool passHEEPV70=(*vidPass)[elePtr]; 
+    bool passHEEPV70=vidPassSpan[eleNr]; 
 
     //lets count the number of pass / fail so we can compare against the reference
-    if(passHEEPV70) globalCache()->nrPass++;
-    else globalCache()->nrFail++;
+    if(passHEEPV70){ nrPassFailRun_.nrPass++; nrPassFailLumi_.nrPass++; }
+    else{ nrPassFailRun_.nrFail++; nrPassFailLumi_.nrFail++; }
     
     //this gives us to determine exactly which cuts the electron passed
     //each bit of this unsigned int corresponds to a cut, 0=fail, 1 =pass
-    unsigned int heepV70Bitmap = (*vidBitmap)[elePtr];
+    unsigned int heepV70Bitmap = vidBitmapSpan[eleNr];
+    //and we count how many electrons had each bitmap, see VIDBitmapHist.h
+    bitmapHist_.fill(heepV70Bitmap);
 
     //to make it easier to use, a small class "cutnrs::HEEPV70" (in CutNrs.h")  been created which
     //has sensibly named enum values corresponding to the cut index
@@ -163,21 +365,24 @@ void HEEPV70Example::analyze(const edm::Event& iEvent,const edm::EventSetup& iSe
     //VIDCutCodes<cutnrs::HEEPV70 are identical
     
     using HEEPV70 = VIDCutCodes<cutnrs::HEEPV70>; 
-    //note, here we use a std::intialisation list (the {...}) to make 
-    //vector of all the cuts we would like to pass
-    const bool passEtShowerShapeHE = HEEPV70::pass(heepV70Bitmap,{HEEPV70::ET,HEEPV70::SIGMAIETAIETA,HEEPV70::E2X5OVER5X5,HEEPV70::HADEM});
+    //note, here we pass the cuts we would like to pass as template arguments
+    //so the mask is worked out at compile time and nothing is allocated
+    //HEEPV70::pass(heepV70Bitmap,{HEEPV70::ET,...}) also works but makes a std::vector each call
+    const bool passEtShowerShapeHE = HEEPV70::pass<HEEPV70::ET,HEEPV70::SIGMAIETAIETA,HEEPV70::E2X5OVER5X5,HEEPV70::HADEM>(heepV70Bitmap);
     //we can also tell it to ignore the cuts specified
     //eg lets require all cuts except tracker isolation
-    const bool passN1TrkIso = HEEPV70::pass(heepV70Bitmap,HEEPV70::TRKISO,HEEPV70::IGNORE);
+    const bool passN1TrkIso = HEEPV70::passIgnoring<HEEPV70::TRKISO>(heepV70Bitmap);
 
     //access # saturated crystals in the 5x5
-    int nrSatCrys=(*nrSatCrysMap)[elePtr];
-    if(nrSatCrys!=0) std::cout <<"nrSatCrys "<<nrSatCrys<<std::endl;
+    int nrSatCrys=nrSatCrysSpan[eleNr];
+    if(nrSatCrys!=0){
+      if(auto out = diag_.message(DIAG_NRSATCRYS)) *out <<"nrSatCrys "<<nrSatCrys<<std::endl;
+    }
      
      //access new tracker isolation
-    float trkIso=(*trkIsoMap)[elePtr];
+    float trkIso=trkIsoSpan[eleNr];
     
-    const vid::CutFlowResult& heepCutFlowResult = (*vidResult)[elePtr];
+    const vid::CutFlowResult& heepCutFlowResult = vidResultSpan[eleNr];
 
      //now we are going to access all of the information above via the vid::CutFlowResult 
     //well except for the nrSatCrys which vid doesnt store
@@ -185,14 +390,18 @@ void HEEPV70Example::analyze(const edm::Event& iEvent,const edm::EventSetup& iSe
     //how to check if everything passed:
     const bool passHEEPV70VID = heepCutFlowResult.cutFlowPassed();
 
-    if(passHEEPV70!=passHEEPV70VID) std::cout <<"error in VID HEEP ID result "<<std::endl;
+    if(passHEEPV70!=passHEEPV70VID){
+      if(auto out = diag_.message(DIAG_VIDPASS)) *out <<"error in VID HEEP ID result "<<std::endl;
+    }
     
     //how to get the track isolation from VID
     //note, this works for all cuts except E2x5/E5x5 although this is a feature which is
     //not often used so safer to use the standard accessors
     //trk isolation value is confirmed to be okay though
     const float trkIsoVID = heepCutFlowResult.getValueCutUpon(HEEPV70::TRKISO);
-    if(trkIso!=trkIsoVID) std::cout <<"error in VID trk iso "<<std::endl;
+    if(trkIso!=trkIsoVID){
+      if(auto out = diag_.message(DIAG_VIDTRKISO)) *out <<"error in VID trk iso "<<std::endl;
+    }
     
     //now lets do selective cuts like we did before
     const bool passEtShowerShapeHEVID = heepCutFlowResult.getCutResultByIndex(HEEPV70::ET)
@@ -201,17 +410,71 @@ void HEEPV70Example::analyze(const edm::Event& iEvent,const edm::EventSetup& iSe
       && heepCutFlowResult.getCutResultByIndex(HEEPV70::HADEM);
 
     //now for track isolation
-    //now this may not be the fastest function as it makes a new cut flow...
-    const bool passN1TrkIsoVID = heepCutFlowResult.getCutFlowResultMasking(HEEPV70::TRKISO).cutFlowPassed();
+    //getCutFlowResultMasking(HEEPV70::TRKISO).cutFlowPassed() would work but
+    //is not the fastest function as it makes a new cut flow...
+    //so instead we make a VIDCutFlowView once per electron which copies the pass bits
+    //and values and can then do as many N-1 queries as we like without allocating
+    const VIDCutFlowView<cutnrs::HEEPV70> heepCutFlowView(heepCutFlowResult);
+    const bool passN1TrkIsoVID = heepCutFlowView.passIgnoring(HEEPV70::TRKISO);
 
     //for debuging, all values here printed should be over 5 GeV
-    if(passN1TrkIso && !passHEEPV70) std::cout <<" trk isol "<<trkIso<<std::endl;
+    if(passN1TrkIso && !passHEEPV70){
+      if(auto out = diag_.message(DIAG_TRKISON1)) *out <<" trk isol "<<trkIso<<std::endl;
+    }
     
-    if(passEtShowerShapeHE != passEtShowerShapeHEVID) std::cout <<"error in VID showershape cuts"<<std::endl;
-    if(passN1TrkIso != passN1TrkIsoVID) std::cout <<"error in VID trk iso cuts"<<std::endl;
+    if(passEtShowerShapeHE != passEtShowerShapeHEVID){
+      if(auto out = diag_.message(DIAG_VIDSHOWERSHAPECUTS)) *out <<"error in VID showershape cuts"<<std::endl;
+    }
+    if(passN1TrkIso != passN1TrkIsoVID){
+      if(auto out = diag_.message(DIAG_VIDTRKISOCUTS)) *out <<"error in VID trk iso cuts"<<std::endl;
+    }
    
 
   }
+  timing_.addEvent(startTime,fetchedTime,timing_.now(),nrEles);
+}
+
+void HEEPV70Example::endLuminosityBlock(const edm::LuminosityBlock& iLumi,const edm::EventSetup&)
+{
+  diag_.flush(std::cout,"HEEPV70Example run "+std::to_string(iLumi.run())+" lumi "+std::to_string(iLumi.luminosityBlock()));
+}
+
+void HEEPV70Example::endStream()
+{
+  diag_.flush(std::cout,"HEEPV70Example");
+  std::lock_guard<std::mutex> lock(globalCache()->mutex);
+  globalCache()->diagnostics.add(diag_);
+  globalCache()->bitmapHist.add(bitmapHist_);
+  if(timing_.enabled()) globalCache()->timingStats.push_back(timing_);
+}
+
+void HEEPV70Example::globalEndRunSummary(const edm::Run& iRun,const edm::EventSetup&,const RunContext* iContext,NrPassFail* runNrPassFail)
+{
+  std::cout <<"run "<<iRun.run()<<" nr eles pass "<<runNrPassFail->nrPass<<" / "<<runNrPassFail->nrTot()<<std::endl;
+  std::lock_guard<std::mutex> lock(iContext->global()->mutex);
+  iContext->global()->nrPassFail.add(*runNrPassFail);
+}
+
+//this gives us the pass rate per lumi section so we can trend it against detector conditions
+void HEEPV70Example::globalEndLuminosityBlockSummary(const edm::LuminosityBlock& iLumi,const edm::EventSetup&,const LuminosityBlockContext*,NrPassFail* lumiNrPassFail)
+{
+  std::cout <<"run "<<iLumi.run()<<" lumi "<<iLumi.luminosityBlock()<<" nr eles pass "<<lumiNrPassFail->nrPass<<" / "<<lumiNrPassFail->nrTot()<<" rate "<<lumiNrPassFail->passRate()<<std::endl;
+}
+
+void HEEPV70Example::globalEndJob(const GlobalData* globalData)
+{
+  const NrPassFail& nrPassFail = globalData->nrPassFail;
+  std::cout <<"nr eles pass "<<nrPassFail.nrPass<<" / "<<nrPassFail.nrTot()<<std::endl;
+  globalData->bitmapHist.print(std::cout);
+  globalData->diagnostics.printSummary(std::cout,"HEEPV70Example");
+  if(!globalData->bitmapHistFile.empty()){
+    std::ofstream outFile(globalData->bitmapHistFile);
+    globalData->bitmapHist.write(outFile);
+  }
+  if(!globalData->timingFile.empty()){
+    std::ofstream outFile(globalData->timingFile);
+    HEEPTimingStats::writeJson(outFile,"HEEPV70Example",globalData->timingStats);
+  }
 }
 
 DEFINE_FWK_MODULE(HEEPV70Example);
@@ -0,0 +1,177 @@
+#include "FWCore/Utilities/interface/InputTag.h"
+#include "FWCore/Utilities/interface/EDGetToken.h"
+#include "FWCore/Utilities/interface/Exception.h"
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/stream/EDFilter.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "DataFormats/PatCandidates/interface/Electron.h"
+#include "DataFormats/EgammaCandidates/interface/GsfElectron.h"
+#include "FWCore/Framework/interface/MakerMacros.h"
+#include "DataFormats/Common/interface/ValueMap.h"
+
+#include "HEEP/VID/interface/CutNrs.h"
+#include "HEEP/VID/interface/HEEPUserDataAccessor.h"
+#include "HEEP/VID/interface/ValueMapSpan.h"
+
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+//**********************************************************
+//
+// class: HEEPV70Filter
+//
+// selects events with at least minNrEles electrons passing a set
+// of the HEEP V7.0 cuts, using the VID bitmap
+//
+// the cuts are given by their names in cutnrs::HEEPV70, an electron
+// passes if it passes all of requiredCuts (all cuts if empty) except
+// those in ignoredCuts, eg ignoredCuts=["TRKISO"] selects electrons
+// passing HEEP or HEEP N-1 trk iso
+//
+// the bitmap is read from the vidBitmap value map or, if its label is
+// empty, from the userInt "heepElectronID_HEEPV70Bitmap" of the electrons
+// (which then must be pat::Electrons), if an electron does not have that
+// userInt it throws rather than rejecting the event as HEEPUserDataAccessor
+// is not told to allow missing keys
+//
+// to make rejected events as cheap as possible, the electrons are
+// counted before reading the bitmaps (so if VID is run unscheduled, it
+// isnt run at all for events with too few electrons) and it stops
+// looking once it has enough electrons
+//
+// the accept rate of each stream is added together at the end of the
+// stream and printed at the end of the job
+//
+//**********************************************************
+
+namespace{
+  struct alignas(64) NrAccept {
+    NrAccept():nrEvents(0),nrAccepted(0){}
+    uint64_t nrEvents;
+    uint64_t nrAccepted;
+
+    void add(const NrAccept& rhs){nrEvents+=rhs.nrEvents;nrAccepted+=rhs.nrAccepted;}
+    double acceptRate()const{return nrEvents!=0 ? static_cast<double>(nrAccepted)/nrEvents : 0.;}
+  };
+  struct GlobalData {
+    mutable std::mutex mutex;
+    mutable NrAccept nrAccept;
+  };
+}
+
+class HEEPV70Filter : public edm::stream::EDFilter<edm::GlobalCache<GlobalData> > {
+
+private:
+  edm::EDGetTokenT<edm::View<reco::GsfElectron> > elesToken_;
+  edm::EDGetTokenT<edm::View<pat::Electron> > patElesToken_;
+  edm::EDGetTokenT<edm::ValueMap<unsigned int> > vidBitmapToken_;
+  bool useUserInt_;
+  HEEPUserDataAccessor heepUserData_;
+
+  size_t minNrEles_;
+  unsigned int mask_;
+
+  NrAccept nrAccept_;
+
+public:
+  explicit HEEPV70Filter(const edm::ParameterSet& iPara,const GlobalData*);
+  virtual ~HEEPV70Filter(){}
+
+  static std::unique_ptr<GlobalData> initializeGlobalCache(const edm::ParameterSet&) {
+    return std::make_unique<GlobalData>();
+  }
+  static void globalEndJob(const GlobalData* globalData);
+
+private:
+  bool filter(edm::Event& iEvent,const edm::EventSetup& iSetup) override;
+  void endStream() override;
+
+  template<typename Ele,typename BitmapFunc>
+  bool enoughElesPass(const edm::View<Ele>& eles,BitmapFunc bitmap)const;
+  static unsigned int cutNrsMask(const std::vector<std::string>& cutNames);
+};
+
+HEEPV70Filter::HEEPV70Filter(const edm::ParameterSet& iPara,const GlobalData*):
+  minNrEles_(iPara.getParameter<unsigned int>("minNrEles"))
+{
+  const edm::InputTag vidBitmapTag = iPara.getParameter<edm::InputTag>("vidBitmap");
+  useUserInt_ = vidBitmapTag.label().empty();
+  if(useUserInt_){
+    patElesToken_=consumes<edm::View<pat::Electron> >(iPara.getParameter<edm::InputTag>("eles"));
+  }else{
+    elesToken_=consumes<edm::View<reco::GsfElectron> >(iPara.getParameter<edm::InputTag>("eles"));
+    vidBitmapToken_=consumes<edm::ValueMap<unsigned int> >(vidBitmapTag);
+  }
+
+  const auto requiredCuts = iPara.getParameter<std::vector<std::string> >("requiredCuts");
+  const unsigned int requiredMask = requiredCuts.empty() ? cutnrs::HEEPV70::kFullMask : cutNrsMask(requiredCuts);
+  mask_ = requiredMask & ~cutNrsMask(iPara.getParameter<std::vector<std::string> >("ignoredCuts"));
+}
+
+unsigned int HEEPV70Filter::cutNrsMask(const std::vector<std::string>& cutNames)
+{
+  unsigned int mask=0x0;
+  for(auto& cutName : cutNames){
+    unsigned int cutNr=0;
+    while(cutNr<=cutnrs::HEEPV70::kMaxBitNr && cutName!=cutnrs::HEEPV70::name(cutNr)) cutNr++;
+    if(cutNr>cutnrs::HEEPV70::kMaxBitNr){
+      throw cms::Exception("Configuration") <<"HEEPV70Filter: "<<cutName<<" is not a cut of cutnrs::HEEPV70";
+    }
+    mask|=0x1<<cutNr;
+  }
+  return mask;
+}
+
+template<typename Ele,typename BitmapFunc>
+bool HEEPV70Filter::enoughElesPass(const edm::View<Ele>& eles,BitmapFunc bitmap)const
+{
+  size_t nrPass=0;
+  for(size_t eleNr=0;eleNr<eles.size() && nrPass<minNrEles_;eleNr++){
+    if((bitmap(eleNr)&mask_)==mask_) nrPass++;
+  }
+  return nrPass>=minNrEles_;
+}
+
+bool HEEPV70Filter::filter(edm::Event& iEvent,const edm::EventSetup& iSetup)
+{
+  nrAccept_.nrEvents++;
+  bool accept=false;
+  if(useUserInt_){
+    edm::Handle<edm::View<pat::Electron> > elesHandle;
+    iEvent.getByToken(patElesToken_,elesHandle);
+    if(elesHandle->size()>=minNrEles_){
+      heepUserData_.resolve(*elesHandle);
+      const edm::View<pat::Electron>& eles = *elesHandle;
+      accept = enoughElesPass(eles,[this,&eles](size_t eleNr){return heepUserData_.bitmap(eles[eleNr]);});
+    }
+  }else{
+    edm::Handle<edm::View<reco::GsfElectron> > elesHandle;
+    iEvent.getByToken(elesToken_,elesHandle);
+    if(elesHandle->size()>=minNrEles_){
+      edm::Handle<edm::ValueMap<unsigned int> > vidBitmapHandle;
+      iEvent.getByToken(vidBitmapToken_,vidBitmapHandle);
+      const ValueMapSpan<unsigned int> bitmaps(*vidBitmapHandle,elesHandle.id(),elesHandle->size());
+      accept = enoughElesPass(*elesHandle,[&bitmaps](size_t eleNr){return bitmaps[eleNr];});
+    }
+  }
+  if(accept) nrAccept_.nrAccepted++;
+  return accept;
+}
+
+void HEEPV70Filter::endStream()
+{
+  std::lock_guard<std::mutex> lock(globalCache()->mutex);
+  globalCache()->nrAccept.add(nrAccept_);
+}
+
+void HEEPV70Filter::globalEndJob(const GlobalData* globalData)
+{
+  const NrAccept& nrAccept = globalData->nrAccept;
+  std::cout <<"HEEPV70Filter accepted "<<nrAccept.nrAccepted<<" / "<<nrAccept.nrEvents<<" events, rate "<<nrAccept.acceptRate()<<std::endl;
+}
+
+DEFINE_FWK_MODULE(HEEPV70Filter);
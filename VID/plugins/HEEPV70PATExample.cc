@@ -1,6 +1,8 @@
 #include "FWCore/Utilities/interface/InputTag.h"
 #include "FWCore/Utilities/interface/EDGetToken.h"
 #include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/Run.h"
+#include "FWCore/Framework/interface/LuminosityBlock.h"
 #include "FWCore/Framework/interface/stream/EDAnalyzer.h"
 #include "FWCore/ParameterSet/interface/ParameterSet.h"
 #include "DataFormats/Common/interface/Ptr.h"
@@ -18,6 +20,20 @@
 //useful
 #include "HEEP/VID/interface/CutNrs.h"
 #include "HEEP/VID/interface/VIDCutCodes.h"
+#include "HEEP/VID/interface/VIDBitmapHist.h"
+#include "HEEP/VID/interface/VIDCutFlowView.h"
+#include "HEEP/VID/interface/HEEPTimingStats.h"
+#include "HEEP/VID/interface/HEEPDiagnostics.h"
+#include "HEEP/VID/interface/HEEPUserDataAccessor.h"
+#include "HEEP/VID/interface/HEEPV70CompactResult.h"
+
+#include <cmath>
+#include <fstream>
+#include <mutex>
+#include <memory>
+#include <cstdint>
+#include <string>
+#include <vector>
 
 //**********************************************************
 //
@@ -44,71 +60,153 @@
 //     the full vid::CutFlowResult with almost full information about 
 //     which cuts passed/failed etc
 //     contains all of over the above information except for nr of sat crys
+// userData<HEEPV70CompactResult>("heepElectronID_HEEPV70Compact") :
+//     only with addHEEPV70ElesMiniAOD(useFusedEmbedder=True,useCompactVIDResult=True)
+//     in which case it replaces the vid::CutFlowResult, it has the same accessors
+//     but its values are rounded to compactVIDResultMantissaBits (default 10)
+//
+// you can access them directly via the userInt/userFloat/userData functions
+// but HEEPUserDataAccessor makes the keys once rather than for every call
+// which is what we do here
 
 
 
 //a struct to count the number of electrons passing/failing
 //see https://twiki.cern.ch/twiki/bin/view/CMSPublic/FWMultithreadedFrameworkStreamModuleInterface
 //if you dont understand why I'm doing this
+//each stream counts its own electrons so nothing is shared in the per electron loop
+//these are then added together per lumi section and run using the summary caches
+//and per job in the global cache
+//its aligned to a cache line so the counters of different streams never share one
 namespace{
-  struct NrPassFail {
+  struct alignas(64) NrPassFail {
     NrPassFail():nrPass(0),nrFail(0){}
-    mutable std::atomic<int> nrPass;
-    mutable std::atomic<int> nrFail;
+    uint64_t nrPass;
+    uint64_t nrFail;
+    
+    void add(const NrPassFail& rhs){nrPass+=rhs.nrPass;nrFail+=rhs.nrFail;}
+    void clear(){nrPass=0;nrFail=0;}
+    uint64_t nrTot()const{return nrPass+nrFail;}
+    double passRate()const{return nrTot()!=0 ? static_cast<double>(nrPass)/nrTot() : 0.;}
+  };
+  //the categories of the messages of the per electron loop, see HEEPDiagnostics.h
+  enum DiagCat {DIAG_NRSATCRYS=0,DIAG_VIDPASS,DIAG_VIDTRKISO,DIAG_VIDSHOWERSHAPECUTS,DIAG_VIDTRKISOCUTS};
+  const std::vector<std::string> kDiagCatNames={"nrSatCrys","vidPassMismatch","vidTrkIsoMismatch","vidShowerShapeCutsMismatch",
+						"vidTrkIsoCutsMismatch"};
+
+  //the job wide data, the bitmap histogram counts how many electrons had
+  //each bitmap so we can work out the efficiency of any cut combination
+  //after the job (optionally written to bitmapHistFile)
+  //each stream fills its own histogram which is added to this one at the end of the stream
+  //if timingFile is set, each stream also times its events and the timings of all
+  //streams are written there as json at the end of the job, see HEEPTimingStats.h
+  struct GlobalData {
+    explicit GlobalData(const edm::ParameterSet& iPara):
+      bitmapHistFile(iPara.getUntrackedParameter<std::string>("bitmapHistFile","")),
+      timingFile(iPara.getUntrackedParameter<std::string>("timingFile","")),
+      diagnostics(kDiagCatNames){}
+    std::string bitmapHistFile;
+    std::string timingFile;
+    mutable std::mutex mutex;
+    mutable NrPassFail nrPassFail;
+    mutable VIDBitmapHist<cutnrs::HEEPV70> bitmapHist;
+    mutable std::vector<HEEPTimingStats> timingStats;
+    mutable HEEPDiagnostics diagnostics;
   };
 }
 
-class HEEPV70PATExample : public edm::stream::EDAnalyzer<edm::GlobalCache<NrPassFail>> {
+class HEEPV70PATExample : public edm::stream::EDAnalyzer<edm::GlobalCache<GlobalData>,
+								       edm::RunSummaryCache<NrPassFail>,
+								       edm::LuminosityBlockSummaryCache<NrPassFail> > {
 
 private:
  
+  NrPassFail nrPassFailRun_;
+  NrPassFail nrPassFailLumi_;
+  VIDBitmapHist<cutnrs::HEEPV70> bitmapHist_;
+  HEEPTimingStats timing_;
+  //the messages of the per electron loop are buffered here and written at the end of the lumi
+  HEEPDiagnostics diag_;
+
   edm::EDGetTokenT<edm::View<pat::Electron> > eleToken_;
+  HEEPUserDataAccessor heepUserData_;
+  //the precision of the values of the HEEPV70CompactResult if thats embeded rather than the vid::CutFlowResult
+  unsigned int compactVIDResultMantissaBits_;
   
 public:
-  explicit HEEPV70PATExample(const edm::ParameterSet& iPara,const NrPassFail*);
+  explicit HEEPV70PATExample(const edm::ParameterSet& iPara,const GlobalData*);
   virtual ~HEEPV70PATExample(){}
   
-  static std::unique_ptr<NrPassFail> initializeGlobalCache(const edm::ParameterSet&) {
-    return std::make_unique<NrPassFail>();
+  static std::unique_ptr<GlobalData> initializeGlobalCache(const edm::ParameterSet& iPara) {
+    return std::make_unique<GlobalData>(iPara);
   }
   void analyze(const edm::Event& iEvent,const edm::EventSetup& iSetup) override;
-  static void globalEndJob(const NrPassFail* nrPassFail) {
-    std::cout <<"nr eles pass "<<nrPassFail->nrPass<<" / "<<nrPassFail->nrPass+nrPassFail->nrFail<<std::endl;
+  void endStream() override;
+  static void globalEndJob(const GlobalData* globalData);
+
+  void beginRun(const edm::Run&,const edm::EventSetup&) override{nrPassFailRun_.clear();}
+  static std::shared_ptr<NrPassFail> globalBeginRunSummary(const edm::Run&,const edm::EventSetup&,const RunContext*){
+    return std::make_shared<NrPassFail>();
   }
+  void endRunSummary(const edm::Run&,const edm::EventSetup&,NrPassFail* runNrPassFail)const override{
+    runNrPassFail->add(nrPassFailRun_);
+  }
+  static void globalEndRunSummary(const edm::Run& iRun,const edm::EventSetup&,const RunContext* iContext,NrPassFail* runNrPassFail);
+ 
+  void beginLuminosityBlock(const edm::LuminosityBlock&,const edm::EventSetup&) override{nrPassFailLumi_.clear();}
+  void endLuminosityBlock(const edm::LuminosityBlock& iLumi,const edm::EventSetup&) override;
+  static std::shared_ptr<NrPassFail> globalBeginLuminosityBlockSummary(const edm::LuminosityBlock&,const edm::EventSetup&,const LuminosityBlockContext*){
+    return std::make_shared<NrPassFail>();
+  }
+  void endLuminosityBlockSummary(const edm::LuminosityBlock&,const edm::EventSetup&,NrPassFail* lumiNrPassFail)const override{
+    lumiNrPassFail->add(nrPassFailLumi_);
+  }
+  static void globalEndLuminosityBlockSummary(const edm::LuminosityBlock& iLumi,const edm::EventSetup&,const LuminosityBlockContext*,NrPassFail* lumiNrPassFail);
   
 };
   
 
-HEEPV70PATExample::HEEPV70PATExample(const edm::ParameterSet& iPara,const NrPassFail*)
+HEEPV70PATExample::HEEPV70PATExample(const edm::ParameterSet& iPara,const GlobalData* globalData):
+  timing_(!globalData->timingFile.empty()),
+  diag_(kDiagCatNames,iPara.getUntrackedParameter<unsigned int>("maxDiagMsgsPerLumi",10),
+	iPara.getUntrackedParameter<unsigned int>("diagSampleEvery",0)),
+  compactVIDResultMantissaBits_(iPara.getUntrackedParameter<unsigned int>("compactVIDResultMantissaBits",10))
 {
   eleToken_=consumes<edm::View<pat::Electron> >(iPara.getParameter<edm::InputTag>("eles")); 
 }
 
 void HEEPV70PATExample::analyze(const edm::Event& iEvent,const edm::EventSetup& iSetup)
 {
+  auto startTime = timing_.now();
   edm::Handle<edm::View<pat::Electron> > eleHandle;
  
   iEvent.getByToken(eleToken_,eleHandle);
- 
+  //works out which of the HEEP user data are present in this collection
+  heepUserData_.resolve(*eleHandle);
+  auto fetchedTime = timing_.now();
 
   for(auto& ele : *eleHandle){
 
     //first we are going to access this ignoring the vid::CutFlowResult
 
-    //access new tracker isolation
-    const float trkIso = ele.userFloat("trkPtIso");
-    //access # saturated crystals in the 5x5
-    const float nrSatCrys = ele.userInt("nrSatCrys");
-    //access the HEEP ID pass / fail
-    const bool heepID = ele.userInt("heepElectronID_HEEPV70");
-    //access the detailed information on the HEEP ID
-    const int heepIDBits = ele.userInt("heepElectronID_HEEPV70Bitmap");
+    //access new tracker isolation, ie ele.userFloat("trkPtIso")
+    const float trkIso = heepUserData_.trkPtIso(ele);
+    //access # saturated crystals in the 5x5, ie ele.userInt("nrSatCrys")
+    const float nrSatCrys = heepUserData_.nrSatCrys(ele);
+    //access the HEEP ID pass / fail, ie ele.userInt("heepElectronID_HEEPV70")
+    const bool heepID = heepUserData_.pass(ele);
+    //access the detailed information on the HEEP ID, ie ele.userInt("heepElectronID_HEEPV70Bitmap")
+    const int heepIDBits = heepUserData_.bitmap(ele);
   
-    if(nrSatCrys!=0) std::cout <<"nrSatCrys "<<nrSatCrys<<std::endl;
+    if(nrSatCrys!=0){
+      if(auto out = diag_.message(DIAG_NRSATCRYS)) *out <<"nrSatCrys "<<nrSatCrys<<std::endl;
+    }
 
     //lets count the number of pass / fail so we can compare against the reference
-    if(heepID) globalCache()->nrPass++;
-    else globalCache()->nrFail++;
+    if(heepID){ nrPassFailRun_.nrPass++; nrPassFailLumi_.nrPass++; }
+    else{ nrPassFailRun_.nrFail++; nrPassFailLumi_.nrFail++; }
+    //and we count how many electrons had each bitmap, see VIDBitmapHist.h
+    bitmapHist_.fill(heepIDBits);
     
 
     //the HEEP ID bits can be turn cuts on and off again
@@ -118,47 +216,111 @@ void HEEPV70PATExample::analyze(const edm::Event& iEvent,const edm::EventSetup&
     //cutnrs::HEEPV70 defines an enum corresponding each cut to bit
     //VIDCutCodes uses this to give nice pass / fail functions
     using HEEPV70 = VIDCutCodes<cutnrs::HEEPV70>;
-    //note, here we use a std::intialisation list (the {...}) to make 
-    //vector of all the cuts we would like to pass
-    const bool passEtShowerShapeHE = HEEPV70::pass(heepIDBits,{HEEPV70::ET,HEEPV70::SIGMAIETAIETA,HEEPV70::E2X5OVER5X5,HEEPV70::HADEM});
+    //note, here we pass the cuts we would like to pass as template arguments
+    //so the mask is worked out at compile time and nothing is allocated
+    //HEEPV70::pass(heepIDBits,{HEEPV70::ET,...}) also works but makes a std::vector each call
+    const bool passEtShowerShapeHE = HEEPV70::pass<HEEPV70::ET,HEEPV70::SIGMAIETAIETA,HEEPV70::E2X5OVER5X5,HEEPV70::HADEM>(heepIDBits);
 
     //now lets require all cuts except tracker isolation
-    const bool passN1TrkIso = HEEPV70::pass(heepIDBits,HEEPV70::TRKISO,HEEPV70::IGNORE);
+    const bool passN1TrkIso = HEEPV70::passIgnoring<HEEPV70::TRKISO>(heepIDBits);
 
     //now we are going to access all of the information above via the vid::CutFlowResult 
     //well except for the nrSatCrys
+    //if the electrons were made with addHEEPV70ElesMiniAOD(process,useFusedEmbedder=True,useCompactVIDResult=True)
+    //there is no vid::CutFlowResult but a HEEPV70CompactResult instead which has the same accessors
+    //so we write this once for either (its values are rounded, hence the trk isol tolerance)
+    auto checkVIDResult = [&](const auto& vidResult,float trkIsoTolerance){
+      //how to check if everything passed:
+      const bool heepIDVID = vidResult.cutFlowPassed();
 
-    //this will be null if its not present
-    const vid::CutFlowResult* vidResult =  ele.userData<vid::CutFlowResult>("heepElectronID_HEEPV70");
-    //how to check if everything passed:
-    const bool heepIDVID = vidResult->cutFlowPassed();
-
-    if(heepID!=heepIDVID) std::cout <<"error in VID HEEP ID result "<<std::endl;
+      if(heepID!=heepIDVID){
+	if(auto out = diag_.message(DIAG_VIDPASS)) *out <<"error in VID HEEP ID result "<<std::endl;
+      }
     
-    //how to get the track isolation from VID
-    //note, this works for all cuts except E2x5/E5x5 although this is a feature which is
-    //not often used so safer to use the standard accessors
-    //trk isolation value is confirmed to be okay though
-    const float trkIsoVID = vidResult->getValueCutUpon(HEEPV70::TRKISO);
-    if(trkIso!=trkIsoVID) std::cout <<"error in VID trk isol "<<std::endl;
+      //how to get the track isolation from VID
+      //note, this works for all cuts except E2x5/E5x5 although this is a feature which is
+      //not often used so safer to use the standard accessors
+      //trk isolation value is confirmed to be okay though
+      const float trkIsoVID = vidResult.getValueCutUpon(HEEPV70::TRKISO);
+      if(std::abs(trkIso-trkIsoVID)>trkIsoTolerance){
+	if(auto out = diag_.message(DIAG_VIDTRKISO)) *out <<"error in VID trk isol "<<std::endl;
+      }
     
-    //now lets do selective cuts like we did before
-    const bool passEtShowerShapeHEVID = vidResult->getCutResultByIndex(HEEPV70::ET)
-      && vidResult->getCutResultByIndex(HEEPV70::SIGMAIETAIETA) 
-      && vidResult->getCutResultByIndex(HEEPV70::E2X5OVER5X5)
-      && vidResult->getCutResultByIndex(HEEPV70::HADEM);
-
-    //now for track isolation
-    //now this may not be the fastest function as it makes a new cut flow...
-    const bool passN1TrkIsoVID = vidResult->getCutFlowResultMasking(HEEPV70::TRKISO).cutFlowPassed();
+      //now lets do selective cuts like we did before
+      const bool passEtShowerShapeHEVID = vidResult.getCutResultByIndex(HEEPV70::ET)
+	&& vidResult.getCutResultByIndex(HEEPV70::SIGMAIETAIETA) 
+	&& vidResult.getCutResultByIndex(HEEPV70::E2X5OVER5X5)
+	&& vidResult.getCutResultByIndex(HEEPV70::HADEM);
+
+      //now for track isolation
+      //getCutFlowResultMasking(HEEPV70::TRKISO).cutFlowPassed() would work but
+      //is not the fastest function as it makes a new cut flow...
+      //so instead we make a VIDCutFlowView once per electron which copies the pass bits
+      //and values and can then do as many N-1 queries as we like without allocating
+      const VIDCutFlowView<cutnrs::HEEPV70> heepCutFlowView(vidResult);
+      const bool passN1TrkIsoVID = heepCutFlowView.passIgnoring(HEEPV70::TRKISO);
     
-    if(passEtShowerShapeHE != passEtShowerShapeHEVID) std::cout <<"error in VID showershape cuts"<<std::endl;
-    if(passN1TrkIso != passN1TrkIsoVID) std::cout <<"error in VID trk iso cuts"<<std::endl;
-   
+      if(passEtShowerShapeHE != passEtShowerShapeHEVID){
+	if(auto out = diag_.message(DIAG_VIDSHOWERSHAPECUTS)) *out <<"error in VID showershape cuts"<<std::endl;
+      }
+      if(passN1TrkIso != passN1TrkIsoVID){
+	if(auto out = diag_.message(DIAG_VIDTRKISOCUTS)) *out <<"error in VID trk iso cuts"<<std::endl;
+      }
+    };
+
+    //these will be null if they are not present, ie ele.userData<vid::CutFlowResult>("heepElectronID_HEEPV70")
+    //and ele.userData<HEEPV70CompactResult>("heepElectronID_HEEPV70Compact"), if neither is we skip this
+    if(const vid::CutFlowResult* vidResult = heepUserData_.cutFlowResult(ele)){
+      checkVIDResult(*vidResult,0.f);
+    }else if(const HEEPV70CompactResult* compactResult = heepUserData_.compactResult(ele)){
+      checkVIDResult(*compactResult,HEEPV70CompactResult::maxRoundingError(trkIso,compactVIDResultMantissaBits_));
+    }
 
   }
-  
- 
+  timing_.addEvent(startTime,fetchedTime,timing_.now(),eleHandle->size());
+}
+
+void HEEPV70PATExample::endLuminosityBlock(const edm::LuminosityBlock& iLumi,const edm::EventSetup&)
+{
+  diag_.flush(std::cout,"HEEPV70PATExample run "+std::to_string(iLumi.run())+" lumi "+std::to_string(iLumi.luminosityBlock()));
+}
+
+void HEEPV70PATExample::endStream()
+{
+  diag_.flush(std::cout,"HEEPV70PATExample");
+  std::lock_guard<std::mutex> lock(globalCache()->mutex);
+  globalCache()->diagnostics.add(diag_);
+  globalCache()->bitmapHist.add(bitmapHist_);
+  if(timing_.enabled()) globalCache()->timingStats.push_back(timing_);
+}
+
+void HEEPV70PATExample::globalEndRunSummary(const edm::Run& iRun,const edm::EventSetup&,const RunContext* iContext,NrPassFail* runNrPassFail)
+{
+  std::cout <<"run "<<iRun.run()<<" nr eles pass "<<runNrPassFail->nrPass<<" / "<<runNrPassFail->nrTot()<<std::endl;
+  std::lock_guard<std::mutex> lock(iContext->global()->mutex);
+  iContext->global()->nrPassFail.add(*runNrPassFail);
+}
+
+//this gives us the pass rate per lumi section so we can trend it against detector conditions
+void HEEPV70PATExample::globalEndLuminosityBlockSummary(const edm::LuminosityBlock& iLumi,const edm::EventSetup&,const LuminosityBlockContext*,NrPassFail* lumiNrPassFail)
+{
+  std::cout <<"run "<<iLumi.run()<<" lumi "<<iLumi.luminosityBlock()<<" nr eles pass "<<lumiNrPassFail->nrPass<<" / "<<lumiNrPassFail->nrTot()<<" rate "<<lumiNrPassFail->passRate()<<std::endl;
+}
+
+void HEEPV70PATExample::globalEndJob(const GlobalData* globalData)
+{
+  const NrPassFail& nrPassFail = globalData->nrPassFail;
+  std::cout <<"nr eles pass "<<nrPassFail.nrPass<<" / "<<nrPassFail.nrTot()<<std::endl;
+  globalData->bitmapHist.print(std::cout);
+  globalData->diagnostics.printSummary(std::cout,"HEEPV70PATExample");
+  if(!globalData->bitmapHistFile.empty()){
+    std::ofstream outFile(globalData->bitmapHistFile);
+    globalData->bitmapHist.write(outFile);
+  }
+  if(!globalData->timingFile.empty()){
+    std::ofstream outFile(globalData->timingFile);
+    HEEPTimingStats::writeJson(outFile,"HEEPV70PATExample",globalData->timingStats);
+  }
 }
 
 DEFINE_FWK_MODULE(HEEPV70PATExample);
@@ -0,0 +1,130 @@
+#include "FWCore/Utilities/interface/InputTag.h"
+#include "FWCore/Utilities/interface/EDGetToken.h"
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/stream/EDAnalyzer.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "DataFormats/PatCandidates/interface/Electron.h"
+#include "FWCore/Framework/interface/MakerMacros.h"
+#include "DataFormats/PatCandidates/interface/VIDCutFlowResult.h"
+
+#include "HEEP/VID/interface/HEEPUserDataAccessor.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <mutex>
+#include <cstdint>
+
+//**********************************************************
+//
+// class: HEEPV70PATUserDataBenchmark
+//
+// times reading the HEEP user data from the pat::Electron via
+// the string lookups (ele.userInt("nrSatCrys") etc) vs HEEPUserDataAccessor
+//
+// each event the electrons are read nrRepeats times with each method
+// to get a time large enough to measure, the time per electron for
+// each method is printed at the end of the job
+//
+//**********************************************************
+
+namespace{
+  struct Timings {
+    Timings():nrEles(0),stringLookupNs(0),accessorNs(0){}
+    uint64_t nrEles;
+    uint64_t stringLookupNs;
+    uint64_t accessorNs;
+
+    void add(const Timings& rhs){
+      nrEles+=rhs.nrEles;
+      stringLookupNs+=rhs.stringLookupNs;
+      accessorNs+=rhs.accessorNs;
+    }
+  };
+  struct GlobalData {
+    mutable std::mutex mutex;
+    mutable Timings timings;
+  };
+}
+
+class HEEPV70PATUserDataBenchmark : public edm::stream::EDAnalyzer<edm::GlobalCache<GlobalData>> {
+
+private:
+  edm::EDGetTokenT<edm::View<pat::Electron> > eleToken_;
+  int nrRepeats_;
+  HEEPUserDataAccessor heepUserData_;
+  Timings timings_;
+  float sink_; //so the compiler cant optimise away the reads
+
+public:
+  explicit HEEPV70PATUserDataBenchmark(const edm::ParameterSet& iPara,const GlobalData*);
+  virtual ~HEEPV70PATUserDataBenchmark(){}
+
+  static std::unique_ptr<GlobalData> initializeGlobalCache(const edm::ParameterSet&) {
+    return std::make_unique<GlobalData>();
+  }
+  void analyze(const edm::Event& iEvent,const edm::EventSetup& iSetup) override;
+  void endStream() override;
+  static void globalEndJob(const GlobalData* globalData);
+
+private:
+  static float sum(float trkIso,int nrSatCrys,bool pass,unsigned int bitmap,const vid::CutFlowResult* vidResult){
+    return trkIso+nrSatCrys+pass+bitmap+(vidResult ? vidResult->cutFlowPassed() : 0);
+  }
+};
+
+HEEPV70PATUserDataBenchmark::HEEPV70PATUserDataBenchmark(const edm::ParameterSet& iPara,const GlobalData*):
+  nrRepeats_(iPara.getUntrackedParameter<int>("nrRepeats",100)),
+  sink_(0.)
+{
+  eleToken_=consumes<edm::View<pat::Electron> >(iPara.getParameter<edm::InputTag>("eles"));
+}
+
+void HEEPV70PATUserDataBenchmark::analyze(const edm::Event& iEvent,const edm::EventSetup& iSetup)
+{
+  edm::Handle<edm::View<pat::Electron> > eleHandle;
+  iEvent.getByToken(eleToken_,eleHandle);
+
+  using Clock = std::chrono::steady_clock;
+
+  auto start = Clock::now();
+  for(int repeatNr=0;repeatNr<nrRepeats_;repeatNr++){
+    for(auto& ele : *eleHandle){
+      sink_+=sum(ele.userFloat("trkPtIso"),ele.userInt("nrSatCrys"),
+		 ele.userInt("heepElectronID_HEEPV70"),ele.userInt("heepElectronID_HEEPV70Bitmap"),
+		 ele.userData<vid::CutFlowResult>("heepElectronID_HEEPV70"));
+    }
+  }
+  auto end = Clock::now();
+  timings_.stringLookupNs+=std::chrono::duration_cast<std::chrono::nanoseconds>(end-start).count();
+
+  start = Clock::now();
+  for(int repeatNr=0;repeatNr<nrRepeats_;repeatNr++){
+    heepUserData_.resolve(*eleHandle); //included in the timing as it would be done per collection
+    for(auto& ele : *eleHandle){
+      const auto data = heepUserData_.get(ele);
+      sink_+=sum(data.trkPtIso,data.nrSatCrys,data.pass,data.bitmap,data.cutFlowResult);
+    }
+  }
+  end = Clock::now();
+  timings_.accessorNs+=std::chrono::duration_cast<std::chrono::nanoseconds>(end-start).count();
+  timings_.nrEles+=eleHandle->size()*nrRepeats_;
+}
+
+void HEEPV70PATUserDataBenchmark::endStream()
+{
+  std::lock_guard<std::mutex> lock(globalCache()->mutex);
+  globalCache()->timings.add(timings_);
+  if(sink_==-1) std::cout <<"sink "<<sink_<<std::endl;
+}
+
+void HEEPV70PATUserDataBenchmark::globalEndJob(const GlobalData* globalData)
+{
+  const Timings& timings = globalData->timings;
+  const double nrEles = std::max(timings.nrEles,static_cast<uint64_t>(1));
+  std::cout <<"nr eles read "<<timings.nrEles<<std::endl;
+  std::cout <<"  string lookups       : "<<timings.stringLookupNs/nrEles<<" ns / ele"<<std::endl;
+  std::cout <<"  HEEPUserDataAccessor : "<<timings.accessorNs/nrEles<<" ns / ele"<<std::endl;
+}
+
+DEFINE_FWK_MODULE(HEEPV70PATUserDataBenchmark);
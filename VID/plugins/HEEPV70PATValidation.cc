@@ -1,6 +1,7 @@
 #include "FWCore/Utilities/interface/InputTag.h"
 #include "FWCore/Utilities/interface/EDGetToken.h"
 #include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/LuminosityBlock.h"
 #include "FWCore/Framework/interface/stream/EDAnalyzer.h"
 #include "FWCore/ParameterSet/interface/ParameterSet.h"
 #include "DataFormats/Common/interface/Ptr.h"
@@ -8,6 +9,18 @@
 #include "FWCore/Framework/interface/MakerMacros.h"
 #include "DataFormats/Common/interface/ValueMap.h"
 #include "DataFormats/PatCandidates/interface/VIDCutFlowResult.h"
+#include "HEEP/VID/interface/HEEPUserDataAccessor.h"
+#include "HEEP/VID/interface/HEEPV70CompactResult.h"
+#include "HEEP/VID/interface/HEEPTimingStats.h"
+#include "HEEP/VID/interface/HEEPDiagnostics.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <mutex>
+#include <cstdint>
+#include <string>
+#include <vector>
 
 namespace heepV70 {
   enum CutIndex {
@@ -16,23 +29,87 @@ namespace heepV70 {
 }
 
 
-class HEEPV70PATValidation : public edm::stream::EDAnalyzer<> {
+//counts of how many electrons were validated for the job
+//in matchByEtaPhi mode, electrons not found in the other collection
+//are counted here rather than throwing an exception
+//nrFullVIDResult and nrCompactVIDResult count the electrons whose
+//vid::CutFlowResult / HEEPV70CompactResult was present and so validated
+//nrValueMismatches counts the values cut upon of these which disagreed
+namespace{
+  struct ValidationStats {
+    ValidationStats():nrEles(0),nrFailed(0),nrUnmatched(0),nrOrgUnmatched(0),nrFullVIDResult(0),nrCompactVIDResult(0),
+		      nrValueMismatches(0){}
+    uint64_t nrEles;
+    uint64_t nrFailed;
+    uint64_t nrUnmatched;
+    uint64_t nrOrgUnmatched;
+    uint64_t nrFullVIDResult;
+    uint64_t nrCompactVIDResult;
+    uint64_t nrValueMismatches;
+    
+    void add(const ValidationStats& rhs){
+      nrEles+=rhs.nrEles;
+      nrFailed+=rhs.nrFailed;
+      nrUnmatched+=rhs.nrUnmatched;
+      nrOrgUnmatched+=rhs.nrOrgUnmatched;
+      nrFullVIDResult+=rhs.nrFullVIDResult;
+      nrCompactVIDResult+=rhs.nrCompactVIDResult;
+      nrValueMismatches+=rhs.nrValueMismatches;
+    }
+  };
+  //the categories of the messages of the per electron loop, see HEEPDiagnostics.h
+  enum DiagCat {DIAG_VALIDATIONFAILED=0};
+  const std::vector<std::string> kDiagCatNames={"validationFailed"};
+
+  //if timingFile is set, each stream times its events and the timings of all
+  //streams are written there as json at the end of the job, see HEEPTimingStats.h
+  struct GlobalData {
+    explicit GlobalData(const edm::ParameterSet& iPara):
+      timingFile(iPara.getUntrackedParameter<std::string>("timingFile","")),
+      diagnostics(kDiagCatNames){}
+    std::string timingFile;
+    mutable std::mutex mutex;
+    mutable ValidationStats stats;
+    mutable std::vector<HEEPTimingStats> timingStats;
+    mutable HEEPDiagnostics diagnostics;
+  };
+}
+
+class HEEPV70PATValidation : public edm::stream::EDAnalyzer<edm::GlobalCache<GlobalData>> {
 
 private:
  
   edm::EDGetTokenT<edm::View<pat::Electron> > elesToken_;
   edm::EDGetTokenT<edm::View<pat::Electron> > orgElesToken_;
   edm::EDGetTokenT<edm::ValueMap<bool> > vidToken_; //VID is versioned ID, is the standard E/gamma ID producer which we have configured for HEEP
+  edm::EDGetTokenT<edm::ValueMap<unsigned int> > vidBitmapToken_;
+  edm::EDGetTokenT<edm::ValueMap<vid::CutFlowResult> > vidResultToken_;
   edm::EDGetTokenT<edm::ValueMap<float> > trkIsoMapToken_;
   edm::EDGetTokenT<edm::ValueMap<int> > nrSatCrysMapToken_;
-
+  HEEPUserDataAccessor heepUserData_;
+  //if true, matches electrons between eles and orgEles by eta/phi rather than
+  //requiring the collections to have the same ordering
+  bool matchByEtaPhi_;
+  //the precision of the values of the HEEPV70CompactResult, its bitmap must be exact
+  unsigned int compactVIDResultMantissaBits_;
+  ValidationStats stats_;
+  HEEPTimingStats timing_;
+  //the failures are buffered here and written at the end of the lumi
+  HEEPDiagnostics diag_;
   
 public:
-  explicit HEEPV70PATValidation(const edm::ParameterSet& iPara);
+  explicit HEEPV70PATValidation(const edm::ParameterSet& iPara,const GlobalData*);
   virtual ~HEEPV70PATValidation(){}
+
+  static std::unique_ptr<GlobalData> initializeGlobalCache(const edm::ParameterSet& iPara) {
+    return std::make_unique<GlobalData>(iPara);
+  }
+  static void globalEndJob(const GlobalData* globalData);
   
 private:
   void analyze(const edm::Event& iEvent,const edm::EventSetup& iSetup) override;
+  void endLuminosityBlock(const edm::LuminosityBlock& iLumi,const edm::EventSetup&) override;
+  void endStream() override;
 };
 
 
@@ -49,6 +126,39 @@ bool hasSameOrdering(const T& coll1,const T& coll2){
   return true;
 }
 
+//for each object in coll1, returns the index of the closest object in coll2
+//within deltaR2<maxDR2, or -1 if there is none, each object in coll2 is matched
+//at most once
+//coll2 is sorted in eta so for each object in coll1 only the objects of coll2
+//in the eta window are checked, so its O(n log n) rather than O(n^2)
+template <typename T>
+std::vector<int> matchByEtaPhi(const T& coll1,const T& coll2,float maxDR2=0.001){
+  std::vector<std::pair<float,size_t> > etaSorted2;
+  etaSorted2.reserve(coll2.size());
+  for(size_t objNr=0;objNr<coll2.size();objNr++) etaSorted2.push_back({coll2[objNr].eta(),objNr});
+  std::sort(etaSorted2.begin(),etaSorted2.end());
+
+  const float maxDR = std::sqrt(maxDR2);
+  std::vector<int> matches(coll1.size(),-1);
+  std::vector<bool> used(coll2.size(),false);
+  for(size_t objNr=0;objNr<coll1.size();objNr++){
+    auto& obj1 = coll1[objNr];
+    auto it = std::lower_bound(etaSorted2.begin(),etaSorted2.end(),std::make_pair(obj1.eta()-maxDR,size_t(0)));
+    float bestDR2 = maxDR2;
+    for(;it!=etaSorted2.end() && it->first<=obj1.eta()+maxDR;++it){
+      if(used[it->second]) continue;
+      auto& obj2 = coll2[it->second];
+      const float dR2 = reco::deltaR2(obj1.eta(),obj1.phi(),obj2.eta(),obj2.phi());
+      if(dR2<=bestDR2){
+	bestDR2 = dR2;
+	matches[objNr] = it->second;
+      }
+    }
+    if(matches[objNr]>=0) used[matches[objNr]]=true;
+  }
+  return matches;
+}
+
 void throwCollectionInvalidException( edm::Handle<edm::View<pat::Electron> > elesHandle,
 				      edm::Handle<edm::View<pat::Electron> > orgElesHandle)
 {
@@ -72,11 +182,18 @@ void throwCollectionInvalidException( edm::Handle<edm::View<pat::Electron> > ele
 
   
 
-HEEPV70PATValidation::HEEPV70PATValidation(const edm::ParameterSet& iPara)
+HEEPV70PATValidation::HEEPV70PATValidation(const edm::ParameterSet& iPara,const GlobalData* globalData):
+  matchByEtaPhi_(iPara.getUntrackedParameter<bool>("matchByEtaPhi",false)),
+  compactVIDResultMantissaBits_(iPara.getUntrackedParameter<unsigned int>("compactVIDResultMantissaBits",10)),
+  timing_(!globalData->timingFile.empty()),
+  diag_(kDiagCatNames,iPara.getUntrackedParameter<unsigned int>("maxDiagMsgsPerLumi",10),
+	iPara.getUntrackedParameter<unsigned int>("diagSampleEvery",0))
 {
   elesToken_=consumes<edm::View<pat::Electron> >(iPara.getParameter<edm::InputTag>("eles"));
   orgElesToken_=consumes<edm::View<pat::Electron> >(iPara.getParameter<edm::InputTag>("orgEles"));
   vidToken_=consumes<edm::ValueMap<bool> >(iPara.getParameter<edm::InputTag>("vid"));
+  vidBitmapToken_=consumes<edm::ValueMap<unsigned int> >(iPara.getParameter<edm::InputTag>("vidBitmap"));
+  vidResultToken_=consumes<edm::ValueMap<vid::CutFlowResult> >(iPara.getParameter<edm::InputTag>("vid"));
   trkIsoMapToken_=consumes<edm::ValueMap<float> >(iPara.getParameter<edm::InputTag>("trkIsoMap"));
   nrSatCrysMapToken_=consumes<edm::ValueMap<int> >(iPara.getParameter<edm::InputTag>("nrSatCrysMap"));
 }
@@ -84,54 +201,156 @@ HEEPV70PATValidation::HEEPV70PATValidation(const edm::ParameterSet& iPara)
 
 void HEEPV70PATValidation::analyze(const edm::Event& iEvent,const edm::EventSetup& iSetup)
 {
+  auto startTime = timing_.now();
   edm::Handle<edm::View<pat::Electron> > elesHandle;
   edm::Handle<edm::View<pat::Electron> > orgElesHandle;
   edm::Handle<edm::ValueMap<bool> > vidHandle;
+  edm::Handle<edm::ValueMap<unsigned int> > vidBitmapHandle;
+  edm::Handle<edm::ValueMap<vid::CutFlowResult> > vidResultHandle;
   edm::Handle<edm::ValueMap<float> > trkIsoMapHandle;
   edm::Handle<edm::ValueMap<int> > nrSatCrysMapHandle;
   
   iEvent.getByToken(elesToken_,elesHandle);
   iEvent.getByToken(orgElesToken_,orgElesHandle);
   iEvent.getByToken(vidToken_,vidHandle);
+  iEvent.getByToken(vidBitmapToken_,vidBitmapHandle);
+  iEvent.getByToken(vidResultToken_,vidResultHandle);
   iEvent.getByToken(trkIsoMapToken_,trkIsoMapHandle);
   iEvent.getByToken(nrSatCrysMapToken_,nrSatCrysMapHandle);
+  auto fetchedTime = timing_.now();
 
-  if(!hasSameOrdering(*elesHandle,*orgElesHandle)){
-    //throws an exception indicating an error
-    throwCollectionInvalidException(elesHandle,orgElesHandle);
+  std::vector<int> orgEleNrs;
+  if(matchByEtaPhi_){
+    orgEleNrs = matchByEtaPhi(*elesHandle,*orgElesHandle);
+    const size_t nrMatched = std::count_if(orgEleNrs.begin(),orgEleNrs.end(),[](int orgEleNr){return orgEleNr>=0;});
+    stats_.nrUnmatched+=elesHandle->size()-nrMatched;
+    stats_.nrOrgUnmatched+=orgElesHandle->size()-nrMatched;
+  }else{
+    if(!hasSameOrdering(*elesHandle,*orgElesHandle)){
+      //throws an exception indicating an error
+      throwCollectionInvalidException(elesHandle,orgElesHandle);
+    }
+    for(size_t eleNr=0;eleNr<elesHandle->size();eleNr++) orgEleNrs.push_back(eleNr);
   }
+  heepUserData_.resolve(*elesHandle);
    
   
   for(size_t eleNr=0;eleNr<elesHandle->size();eleNr++){  
-    edm::Ptr<pat::Electron> orgElePtr(orgElesHandle,eleNr);
+    if(orgEleNrs[eleNr]<0) continue;
+    stats_.nrEles++;
+    edm::Ptr<pat::Electron> orgElePtr(orgElesHandle,orgEleNrs[eleNr]);
     edm::Ptr<pat::Electron> elePtr(elesHandle,eleNr);
     
     const bool passHEEPOrg=(*vidHandle)[orgElePtr]; 
+    const unsigned int bitmapOrg=(*vidBitmapHandle)[orgElePtr];
     const float trkIsoOrg=(*trkIsoMapHandle)[orgElePtr];
     const float nrSatCrysOrg=(*nrSatCrysMapHandle)[orgElePtr];
+    const vid::CutFlowResult& vidResultOrg=(*vidResultHandle)[orgElePtr];
     
-    const vid::CutFlowResult* vidResult =  elePtr->userData<vid::CutFlowResult>("heepElectronID_HEEPV70");
+    const HEEPUserDataAccessor::Data heepData = heepUserData_.get(*elePtr);
+    //with useCompactVIDResult only the HEEPV70CompactResult is embeded, otherwise
+    //only the vid::CutFlowResult, we validate whichever are present
+    const vid::CutFlowResult* vidResult = heepData.cutFlowResult;
+    const HEEPV70CompactResult* compactResult = heepData.compactResult;
     
-    const bool passHEEPUserInt = elePtr->userInt("heepElectronID_HEEPV70");
-    const bool passHEEPVID = vidResult->cutFlowPassed();
-    const float trkIso = elePtr->userFloat("trkPtIso");
-    const float trkIsoVID = vidResult->getValueCutUpon(heepV70::TRKISO);
-    const float nrSatCrys = elePtr->userInt("nrSatCrys");
-
-    bool failValid = false;
-    if(passHEEPUserInt!=passHEEPOrg || passHEEPUserInt!=passHEEPVID) failValid=true;
-    if(trkIsoOrg!=trkIso || trkIso!=trkIsoVID) failValid=true;
+    const bool passHEEPUserInt = heepData.pass;
+    const bool passHEEPVID = vidResult ? vidResult->cutFlowPassed() : false;
+    const bool passHEEPCompact = compactResult ? compactResult->cutFlowPassed() : false;
+    const float trkIso = heepData.trkPtIso;
+    const float trkIsoVID = vidResult ? vidResult->getValueCutUpon(heepV70::TRKISO) : 0.;
+    const float trkIsoCompact = compactResult ? compactResult->getValueCutUpon(heepV70::TRKISO) : 0.;
+    const float nrSatCrys = heepData.nrSatCrys;
+    const unsigned int bitmap = heepData.bitmap;
+    const unsigned int bitmapVID = vidResult ? vidResult->cutFlowBits() : 0;
+    const unsigned int bitmapCompact = compactResult ? compactResult->cutFlowBits() : 0;
+
+    bool failValid = !vidResult && !compactResult;
+    if(passHEEPUserInt!=passHEEPOrg) failValid=true;
+    if(trkIsoOrg!=trkIso) failValid=true;
     if(nrSatCrysOrg!=nrSatCrys) failValid=true;
+    if(bitmapOrg!=bitmap) failValid=true;
+    //every value cut upon is checked, not just the trk iso, the cuts whose values disagree
+    //are set in valueMismatchBits for the message
+    unsigned int valueMismatchBits=0;
+    if(vidResult){
+      stats_.nrFullVIDResult++;
+      if(passHEEPVID!=passHEEPOrg || trkIsoVID!=trkIsoOrg || bitmapVID!=bitmapOrg ||
+	 vidResult->cutFlowSize()!=vidResultOrg.cutFlowSize()) failValid=true;
+      for(unsigned int cutNr=0;cutNr<std::min<size_t>(vidResult->cutFlowSize(),vidResultOrg.cutFlowSize());cutNr++){
+	const double value = vidResult->getValueCutUpon(cutNr);
+	const double valueOrg = vidResultOrg.getValueCutUpon(cutNr);
+	if(value!=valueOrg && !(std::isnan(value) && std::isnan(valueOrg))) valueMismatchBits|=0x1<<cutNr;
+      }
+    }
+    //the bitmap of the compact result is exact, its values are floats rounded to compactVIDResultMantissaBits
+    if(compactResult){
+      stats_.nrCompactVIDResult++;
+      const float maxTrkIsoDiff = HEEPV70CompactResult::maxRoundingError(trkIsoOrg,compactVIDResultMantissaBits_);
+      if(passHEEPCompact!=passHEEPOrg || bitmapCompact!=bitmapOrg ||
+	 std::abs(trkIsoCompact-trkIsoOrg)>maxTrkIsoDiff ||
+	 compactResult->cutFlowSize()!=vidResultOrg.cutFlowSize()) failValid=true;
+      for(unsigned int cutNr=0;cutNr<std::min<size_t>(compactResult->cutFlowSize(),vidResultOrg.cutFlowSize());cutNr++){
+	const float value = compactResult->getValueCutUpon(cutNr);
+	const float valueOrg = vidResultOrg.getValueCutUpon(cutNr);
+	const float maxDiff = HEEPV70CompactResult::maxRoundingError(valueOrg,compactVIDResultMantissaBits_);
+	if(std::abs(value-valueOrg)>maxDiff) valueMismatchBits|=0x1<<cutNr;
+      }
+    }
+    if(valueMismatchBits!=0){
+      stats_.nrValueMismatches+=__builtin_popcount(valueMismatchBits);
+      failValid=true;
+    }
     
     if(failValid){
-      std::cout <<"for event "<<iEvent.id().run()<<" "<<iEvent.luminosityBlock()<<" "<<iEvent.id().event()<<" ele "<<eleNr<<" failed validation"<<std::endl;
-      std::cout <<"  et "<<elePtr->et()<<" eta "<<elePtr->eta()<<" phi "<<elePtr->phi()<<std::endl;
-      std::cout <<"  heepID : org "<<passHEEPOrg<<" UserInt "<<passHEEPUserInt<<" VID "<<passHEEPVID<<std::endl;
-      std::cout <<"  trkIso : org "<<trkIsoOrg<<" UserFloat "<<trkIso<<" VID "<<trkIsoVID<<" CMSSW  value "<<elePtr->dr03TkSumPt()<<std::endl;
-      std::cout <<"  nrSatCrys : org "<<nrSatCrysOrg<<" UserInt "<<elePtr->userInt("nrSatCrys")<<std::endl;
+      stats_.nrFailed++;
+      if(auto out = diag_.message(DIAG_VALIDATIONFAILED)){
+	*out <<"for event "<<iEvent.id().run()<<" "<<iEvent.luminosityBlock()<<" "<<iEvent.id().event()<<" ele "<<eleNr<<" failed validation"<<std::endl;
+	*out <<"  et "<<elePtr->et()<<" eta "<<elePtr->eta()<<" phi "<<elePtr->phi()<<std::endl;
+	*out <<"  VID result "<<(vidResult ? "present" : "missing")<<" compact result "<<(compactResult ? "present" : "missing")<<std::endl;
+	*out <<"  heepID : org "<<passHEEPOrg<<" UserInt "<<passHEEPUserInt<<" VID "<<passHEEPVID<<" compact "<<passHEEPCompact<<std::endl;
+	*out <<"  trkIso : org "<<trkIsoOrg<<" UserFloat "<<trkIso<<" VID "<<trkIsoVID<<" compact "<<trkIsoCompact<<" CMSSW  value "<<elePtr->dr03TkSumPt()<<std::endl;
+	*out <<"  nrSatCrys : org "<<nrSatCrysOrg<<" UserInt "<<nrSatCrys<<std::endl;
+	*out <<"  bitmap : org 0x"<<std::hex<<bitmapOrg<<" UserInt 0x"<<bitmap<<" VID 0x"<<bitmapVID<<" compact 0x"<<bitmapCompact<<std::dec<<std::endl;
+	for(unsigned int cutNr=0;cutNr<vidResultOrg.cutFlowSize();cutNr++){
+	  if(((valueMismatchBits>>cutNr)&0x1)==0) continue;
+	  *out <<"  value cut upon "<<cutNr<<" : org "<<vidResultOrg.getValueCutUpon(cutNr);
+	  if(vidResult) *out <<" VID "<<vidResult->getValueCutUpon(cutNr);
+	  if(compactResult) *out <<" compact "<<compactResult->getValueCutUpon(cutNr);
+	  *out <<std::endl;
+	}
+      }
     }
     
   }
+  timing_.addEvent(startTime,fetchedTime,timing_.now(),elesHandle->size());
+}
+
+void HEEPV70PATValidation::endLuminosityBlock(const edm::LuminosityBlock& iLumi,const edm::EventSetup&)
+{
+  diag_.flush(std::cout,"HEEPV70PATValidation run "+std::to_string(iLumi.run())+" lumi "+std::to_string(iLumi.luminosityBlock()));
+}
+
+void HEEPV70PATValidation::endStream()
+{
+  diag_.flush(std::cout,"HEEPV70PATValidation");
+  std::lock_guard<std::mutex> lock(globalCache()->mutex);
+  globalCache()->diagnostics.add(diag_);
+  globalCache()->stats.add(stats_);
+  if(timing_.enabled()) globalCache()->timingStats.push_back(timing_);
+}
+
+void HEEPV70PATValidation::globalEndJob(const GlobalData* globalData)
+{
+  const ValidationStats& stats = globalData->stats;
+  std::cout <<"nr eles failed validation "<<stats.nrFailed<<" / "<<stats.nrEles<<std::endl;
+  std::cout <<"nr eles unmatched "<<stats.nrUnmatched<<" org eles unmatched "<<stats.nrOrgUnmatched<<std::endl;
+  std::cout <<"nr eles with VID result "<<stats.nrFullVIDResult<<" with compact VID result "<<stats.nrCompactVIDResult<<std::endl;
+  std::cout <<"nr values cut upon which disagree "<<stats.nrValueMismatches<<std::endl;
+  globalData->diagnostics.printSummary(std::cout,"HEEPV70PATValidation");
+  if(!globalData->timingFile.empty()){
+    std::ofstream outFile(globalData->timingFile);
+    HEEPTimingStats::writeJson(outFile,"HEEPV70PATValidation",globalData->timingStats);
+  }
 }
 
 DEFINE_FWK_MODULE(HEEPV70PATValidation);
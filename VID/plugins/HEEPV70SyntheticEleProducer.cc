@@ -0,0 +1,199 @@
+#include "FWCore/Utilities/interface/Exception.h"
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/stream/EDProducer.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "DataFormats/Common/interface/OrphanHandle.h"
+#include "DataFormats/PatCandidates/interface/Electron.h"
+#include "DataFormats/EgammaCandidates/interface/GsfElectron.h"
+#include "DataFormats/Math/interface/LorentzVector.h"
+#include "FWCore/Framework/interface/MakerMacros.h"
+#include "DataFormats/Common/interface/ValueMap.h"
+#include "DataFormats/PatCandidates/interface/VIDCutFlowResult.h"
+
+#include "HEEP/VID/interface/CutNrs.h"
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+//**********************************************************
+//
+// class: HEEPV70SyntheticEleProducer
+//
+// makes a random collection of pat::Electrons with the HEEP V7.0
+// value maps and user data so the HEEP modules can be run and timed
+// with an EmptySource, ie without input files or a global tag
+// (see test/heepV70Synthetic_cfg.py)
+//
+// it puts
+//   std::vector<pat::Electron>, with the same user data as HEEPV70ElectronEmbedder
+//   edm::ValueMap<bool> and edm::ValueMap<vid::CutFlowResult> "heepElectronID-HEEPV70"
+//   edm::ValueMap<unsigned int> "heepElectronID-HEEPV70Bitmap"
+//   edm::ValueMap<float> "eleTrkPtIso"
+//   edm::ValueMap<int> "eleNrSaturateIn5x5"
+// with the value maps made for the electrons it puts
+//
+// the nr of electrons is poisson with mean nrElesMean (at most maxNrEles)
+// and each cut passes independently with the rate given in cutPassRates
+// (index is the cut nr), the E_{T} is minEt plus an exponential with
+// mean etSlope and eta/phi are flat
+//
+// the values cut upon are the electron E_{T} and eta for ET and ETA, the
+// track isolation for TRKISO (below 5 GeV if it passed, above if it failed)
+// and a flat number between 0 and 1 for the rest, so only the first three
+// are meaningful
+//
+// the random numbers are seeded by the seed and the event id so
+// the events are the same for any nr of threads or streams
+//
+//**********************************************************
+
+class HEEPV70SyntheticEleProducer : public edm::stream::EDProducer<> {
+
+private:
+  unsigned int seed_;
+  double nrElesMean_;
+  size_t maxNrEles_;
+  double minEt_;
+  double etSlope_;
+  double maxEta_;
+  std::vector<double> cutPassRates_;
+  double satCrysRate_;
+
+  std::string trkIsoLabel_;
+  std::string nrSatCrysLabel_;
+  std::string vidLabel_;
+  std::string vidBitmapLabel_;
+
+  std::string vidName_;
+  std::map<std::string,unsigned int> cutNamesToIndex_;
+
+public:
+  explicit HEEPV70SyntheticEleProducer(const edm::ParameterSet& iPara);
+  virtual ~HEEPV70SyntheticEleProducer(){}
+
+private:
+  void produce(edm::Event& iEvent,const edm::EventSetup& iSetup) override;
+
+  template<typename T>
+  static void putValueMap(edm::Event& iEvent,const edm::OrphanHandle<std::vector<pat::Electron> >& eleHandle,
+			  const std::vector<T>& values,const std::string& label);
+};
+
+HEEPV70SyntheticEleProducer::HEEPV70SyntheticEleProducer(const edm::ParameterSet& iPara):
+  seed_(iPara.getParameter<unsigned int>("seed")),
+  nrElesMean_(iPara.getParameter<double>("nrElesMean")),
+  maxNrEles_(iPara.getParameter<unsigned int>("maxNrEles")),
+  minEt_(iPara.getParameter<double>("minEt")),
+  etSlope_(iPara.getParameter<double>("etSlope")),
+  maxEta_(iPara.getParameter<double>("maxEta")),
+  cutPassRates_(iPara.getParameter<std::vector<double> >("cutPassRates")),
+  satCrysRate_(iPara.getParameter<double>("satCrysRate")),
+  trkIsoLabel_(iPara.getParameter<std::string>("trkIsoLabel")),
+  nrSatCrysLabel_(iPara.getParameter<std::string>("nrSatCrysLabel")),
+  vidLabel_(iPara.getParameter<std::string>("vidLabel")),
+  vidBitmapLabel_(iPara.getParameter<std::string>("vidBitmapLabel")),
+  vidName_("heepElectronID-HEEPV70")
+{
+  if(cutPassRates_.size()!=cutnrs::HEEPV70::kMaxBitNr+1){
+    throw cms::Exception("Configuration") <<"HEEPV70SyntheticEleProducer: cutPassRates has "<<cutPassRates_.size()
+					  <<" entries, it needs one per cut ("<<cutnrs::HEEPV70::kMaxBitNr+1<<")";
+  }
+  //the names VID gives the HEEP V7.0 cuts
+  const std::vector<std::string> cutNames={
+    "MinPtCut_0","GsfEleSCEtaMultiRangeCut_1","GsfEleDEtaInSeedCut_2","GsfEleDPhiInCut_3",
+    "GsfEleFull5x5SigmaIEtaIEtaWithSatCut_4","GsfEleFull5x5E2x5OverE5x5WithSatCut_5",
+    "GsfEleHadronicOverEMLinearCut_6","GsfEleTrkPtIsoCut_7","GsfEleEmHadD1IsoRhoCut_8",
+    "GsfEleDxyCut_9","GsfEleMissingHitsCut_10","GsfEleEcalDrivenCut_11"};
+  for(size_t cutNr=0;cutNr<cutNames.size();cutNr++) cutNamesToIndex_[cutNames[cutNr]]=cutNr;
+
+  produces<std::vector<pat::Electron> >();
+  produces<edm::ValueMap<bool> >(vidName_);
+  produces<edm::ValueMap<vid::CutFlowResult> >(vidName_);
+  produces<edm::ValueMap<unsigned int> >(vidName_+"Bitmap");
+  produces<edm::ValueMap<float> >("eleTrkPtIso");
+  produces<edm::ValueMap<int> >("eleNrSaturateIn5x5");
+}
+
+void HEEPV70SyntheticEleProducer::produce(edm::Event& iEvent,const edm::EventSetup& iSetup)
+{
+  const unsigned long long eventNr = iEvent.id().event();
+  std::seed_seq seedSeq={seed_,iEvent.id().run(),iEvent.luminosityBlock(),
+			 static_cast<unsigned int>(eventNr),static_cast<unsigned int>(eventNr>>32)};
+  std::mt19937 rng(seedSeq);
+  std::uniform_real_distribution<double> flat(0.,1.);
+  std::exponential_distribution<double> etDist(1./etSlope_);
+  std::poisson_distribution<size_t> nrElesDist(nrElesMean_);
+
+  const size_t nrEles = std::min(nrElesDist(rng),maxNrEles_);
+  auto eles = std::make_unique<std::vector<pat::Electron> >();
+  eles->reserve(nrEles);
+  std::vector<bool> vidPasses;
+  std::vector<vid::CutFlowResult> vidResults;
+  std::vector<unsigned int> vidBitmaps;
+  std::vector<float> trkIsos;
+  std::vector<int> nrSatCryses;
+
+  for(size_t eleNr=0;eleNr<nrEles;eleNr++){
+    const double et = minEt_+etDist(rng);
+    const double eta = (2*flat(rng)-1)*maxEta_;
+    const double phi = (2*flat(rng)-1)*M_PI;
+    const math::PtEtaPhiMLorentzVector p4(et,eta,phi,0.);
+
+    unsigned int bitmap=0x0;
+    for(size_t cutNr=0;cutNr<cutPassRates_.size();cutNr++){
+      if(flat(rng)<cutPassRates_[cutNr]) bitmap|=0x1<<cutNr;
+    }
+    const bool pass = bitmap==cutnrs::HEEPV70::kFullMask;
+    const bool passTrkIso = (bitmap>>cutnrs::HEEPV70::TRKISO)&0x1;
+    const float trkIso = passTrkIso ? 5*flat(rng) : 5+45*flat(rng);
+    const int nrSatCrys = flat(rng)<satCrysRate_ ? 1+static_cast<int>(4*flat(rng)) : 0;
+
+    std::vector<double> values;
+    for(size_t cutNr=0;cutNr<cutPassRates_.size();cutNr++) values.push_back(flat(rng));
+    values[cutnrs::HEEPV70::ET] = et;
+    values[cutnrs::HEEPV70::ETA] = eta;
+    values[cutnrs::HEEPV70::TRKISO] = trkIso;
+    vid::CutFlowResult vidResult(vidName_,"",cutNamesToIndex_,values,bitmap);
+
+    reco::GsfElectron gsfEle;
+    gsfEle.setP4(reco::GsfElectron::P4_COMBINATION,reco::Candidate::LorentzVector(p4),0.,true);
+    eles->emplace_back(gsfEle);
+    pat::Electron& ele = eles->back();
+    ele.addUserFloat(trkIsoLabel_,trkIso);
+    ele.addUserInt(nrSatCrysLabel_,nrSatCrys);
+    ele.addUserInt(vidLabel_,static_cast<int>(pass));
+    ele.addUserInt(vidBitmapLabel_,static_cast<int>(bitmap));
+    ele.addUserData(vidLabel_,vidResult);
+
+    vidPasses.push_back(pass);
+    vidResults.push_back(vidResult);
+    vidBitmaps.push_back(bitmap);
+    trkIsos.push_back(trkIso);
+    nrSatCryses.push_back(nrSatCrys);
+  }
+
+  auto eleHandle = iEvent.put(std::move(eles));
+  putValueMap(iEvent,eleHandle,vidPasses,vidName_);
+  putValueMap(iEvent,eleHandle,vidResults,vidName_);
+  putValueMap(iEvent,eleHandle,vidBitmaps,vidName_+"Bitmap");
+  putValueMap(iEvent,eleHandle,trkIsos,"eleTrkPtIso");
+  putValueMap(iEvent,eleHandle,nrSatCryses,"eleNrSaturateIn5x5");
+}
+
+template<typename T>
+void HEEPV70SyntheticEleProducer::putValueMap(edm::Event& iEvent,const edm::OrphanHandle<std::vector<pat::Electron> >& eleHandle,
+					      const std::vector<T>& values,const std::string& label)
+{
+  auto valueMap = std::make_unique<edm::ValueMap<T> >();
+  typename edm::ValueMap<T>::Filler filler(*valueMap);
+  filler.insert(eleHandle,values.begin(),values.end());
+  filler.fill();
+  iEvent.put(std::move(valueMap),label);
+}
+
+DEFINE_FWK_MODULE(HEEPV70SyntheticEleProducer);
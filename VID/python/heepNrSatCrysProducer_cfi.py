@@ -0,0 +1,16 @@
+import FWCore.ParameterSet.Config as cms
+
+#counts the saturated crystals around the seed crystal of each electron
+#for each window size N (odd) it puts a ValueMap<int> "eleNrSaturateIn<N>x<N>"
+#"eleNrSaturateIn5x5" is the same as heepIDVarValueMaps:eleNrSaturateIn5x5 so
+#  nrSatCrysMap=cms.InputTag("heepNrSatCrysProducer","eleNrSaturateIn5x5")
+#can be used in place of it
+heepNrSatCrysProducer = cms.EDProducer("HEEPNrSatCrysProducer",
+                                       elesAOD=cms.InputTag("gedGsfElectrons"),
+                                       elesMiniAOD=cms.InputTag("slimmedElectrons"),
+                                       ebRecHitsAOD=cms.InputTag("reducedEcalRecHitsEB"),
+                                       eeRecHitsAOD=cms.InputTag("reducedEcalRecHitsEE"),
+                                       ebRecHitsMiniAOD=cms.InputTag("reducedEgamma","reducedEBRecHits"),
+                                       eeRecHitsMiniAOD=cms.InputTag("reducedEgamma","reducedEERecHits"),
+                                       windowSizes=cms.vuint32(5),
+                                       )
@@ -0,0 +1,38 @@
+import FWCore.ParameterSet.Config as cms
+from RecoEgamma.ElectronIdentification.heepIdVarValueMapProducer_cfi import heepIDVarValueMaps as _heepIDVarValueMaps
+
+#the HEEP V7.0 track isolation cuts, as used by heepIDVarValueMaps
+_trkIsoCuts = cms.PSet(
+    minPt=cms.double(1.0),
+    maxDZ=cms.double(0.1),
+    minHits=cms.int32(8),
+    minPixelHits=cms.int32(1),
+    maxDPtPt=cms.double(0.1)
+    )
+
+#calculates the HEEP track isolation for several cones in one pass
+#"eleTrkPtIso" is the nominal HEEP V7.0 isolation so
+#  trkIsoMap=cms.InputTag("heepTrkIsoProducer","eleTrkPtIso")
+#is meant to be usable in place of heepIDVarValueMaps:eleTrkPtIso, check this
+#first with heepV70Example_cfg.py useHEEPTrkIsoProducer=True (vidTrkIsoMismatch must be 0)
+#the 0.2 and 0.4 cones are for systematic studies
+#
+#the candidates are taken from heepIDVarValueMaps of the release so the same
+#tracks are summed, ie on AOD the packedCandsForTkIso/lostTracksForTkIso made
+#by the VID setup (so AOD tracks have the miniAOD precision too) and on miniAOD
+#packedPFCandidates/lostTracks, plus lostTracks:eleTracks in releases which have it
+#heepIDVarValueMaps can also veto candidates (candVetosAOD/candVetosMiniAOD)
+#which this does not do, HEEP V7.0 does not veto any so this makes no difference
+heepTrkIsoProducer = cms.EDProducer("HEEPTrkIsoProducer",
+                                    elesAOD=cms.InputTag("gedGsfElectrons"),
+                                    elesMiniAOD=cms.InputTag("slimmedElectrons"),
+                                    candsAOD=_heepIDVarValueMaps.candsAOD.copy(),
+                                    candsMiniAOD=_heepIDVarValueMaps.candsMiniAOD.copy(),
+                                    barrelCuts=_trkIsoCuts,
+                                    endcapCuts=_trkIsoCuts,
+                                    cones=cms.VPSet(
+        cms.PSet(label=cms.string("eleTrkPtIso"),minDR=cms.double(0.),maxDR=cms.double(0.3),minDEta=cms.double(0.005)),
+        cms.PSet(label=cms.string("eleTrkPtIso02"),minDR=cms.double(0.),maxDR=cms.double(0.2),minDEta=cms.double(0.005)),
+        cms.PSet(label=cms.string("eleTrkPtIso04"),minDR=cms.double(0.),maxDR=cms.double(0.4),minDEta=cms.double(0.005)),
+        )
+                                    )
@@ -0,0 +1,23 @@
+import FWCore.ParameterSet.Config as cms
+
+#a single producer which embeds all the HEEP V7.0 information into the pat::Electrons
+#it makes the same output as the modifiers in heepV70Modifier_cfi but in a single pass
+heepV70ElectronEmbedder = cms.EDProducer("HEEPV70ElectronEmbedder",
+                                         eles=cms.InputTag("slimmedElectrons",processName=cms.InputTag.skipCurrentProcess()),
+                                         trkIsoMap=cms.InputTag("heepIDVarValueMaps","eleTrkPtIso"),
+                                         nrSatCrysMap=cms.InputTag("heepIDVarValueMaps","eleNrSaturateIn5x5"),
+                                         vid=cms.InputTag("egmGsfElectronIDs","heepElectronID-HEEPV70"),
+                                         vidBitmap=cms.InputTag("egmGsfElectronIDs","heepElectronID-HEEPV70Bitmap"),
+                                         trkIsoLabel=cms.string("trkPtIso"),
+                                         nrSatCrysLabel=cms.string("nrSatCrys"),
+                                         vidLabel=cms.string("heepElectronID_HEEPV70"),
+                                         vidBitmapLabel=cms.string("heepElectronID_HEEPV70Bitmap"),
+                                         #set to false to not embed the pass userInt
+                                         embedVIDPass=cms.bool(True),
+                                         #set to false to not embed the vid::CutFlowResult (eg if the compact result is embeded instead)
+                                         embedFullVIDResult=cms.bool(True),
+                                         #if not empty, also embeds a HEEPV70CompactResult with this label
+                                         compactVIDResultLabel=cms.string(""),
+                                         #the nr of bits of mantissa of the values of the compact result (23 = full float precision)
+                                         compactVIDResultMantissaBits=cms.uint32(23),
+                                         )
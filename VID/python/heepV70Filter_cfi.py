@@ -0,0 +1,13 @@
+import FWCore.ParameterSet.Config as cms
+
+#selects events with at least minNrEles electrons passing HEEP V7.0
+#requiredCuts/ignoredCuts are the names in cutnrs::HEEPV70 (CutNrs.h), an empty requiredCuts means all cuts
+#by default it selects dielectron events where both pass HEEP or HEEP N-1 trk iso
+#to read the bitmap from the userInt of pat::Electrons instead, set vidBitmap=cms.InputTag("")
+heepV70Filter = cms.EDFilter("HEEPV70Filter",
+                             eles=cms.InputTag("slimmedElectrons"),
+                             vidBitmap=cms.InputTag("egmGsfElectronIDs","heepElectronID-HEEPV70Bitmap"),
+                             minNrEles=cms.uint32(2),
+                             requiredCuts=cms.vstring(),
+                             ignoredCuts=cms.vstring("TRKISO"),
+                             )
@@ -0,0 +1,19 @@
+import FWCore.ParameterSet.Config as cms
+
+#makes random pat::Electrons with the HEEP V7.0 value maps and user data
+#so the HEEP modules can be run with an EmptySource, see test/heepV70Synthetic_cfg.py
+heepV70SyntheticEles = cms.EDProducer("HEEPV70SyntheticEleProducer",
+                                      seed=cms.uint32(12345),
+                                      nrElesMean=cms.double(2.),
+                                      maxNrEles=cms.uint32(20),
+                                      minEt=cms.double(20.),
+                                      etSlope=cms.double(30.),
+                                      maxEta=cms.double(2.5),
+                                      #one per cut in cutnrs::HEEPV70, roughly Z->ee with E_{T}>20 GeV
+                                      cutPassRates=cms.vdouble(0.80,0.95,0.95,0.97,0.97,0.95,0.97,0.90,0.90,0.98,0.97,0.99),
+                                      satCrysRate=cms.double(0.001),
+                                      trkIsoLabel=cms.string("trkPtIso"),
+                                      nrSatCrysLabel=cms.string("nrSatCrys"),
+                                      vidLabel=cms.string("heepElectronID_HEEPV70"),
+                                      vidBitmapLabel=cms.string("heepElectronID_HEEPV70Bitmap"),
+                                      )
@@ -21,7 +21,12 @@ def setupVIDForHEEPV70(process,useMiniAOD=True):
 
 
 
-def addHEEPV70ElesMiniAOD(process,useStdName=True): 
+#useFusedEmbedder : uses the single HEEPV70ElectronEmbedder producer to add the HEEP
+#                   information to the electrons rather than the five EGExtraInfoModifiers
+#useCompactVIDResult : (needs useFusedEmbedder) embeds a HEEPV70CompactResult as
+#                   userData "heepElectronID_HEEPV70Compact" rather than the full vid::CutFlowResult
+#                   to make the electrons smaller, values are kept to 10 bits of mantissa (~0.1%)
+def addHEEPV70ElesMiniAOD(process,useStdName=True,useFusedEmbedder=False,useCompactVIDResult=False): 
 
     setupVIDForHEEPV70(process,useMiniAOD=True)
     
@@ -34,11 +39,90 @@ def addHEEPV70ElesMiniAOD(process,useStdName=True):
             cms.InputTag("slimmedElectrons",processName=cms.InputTag.skipCurrentProcess())
     
     
-    process.load("HEEP.VID.addHEEPV70ToEles_cfi") 
     process.heepSequence = cms.Sequence(process.egmGsfElectronIDSequence)
-    if useStdName:
-        process.heepSequence.insert(1,process.addHEEPToSlimmedElectrons)
+    if useFusedEmbedder:
+        process.load("HEEP.VID.heepV70ElectronEmbedder_cfi")
+        eleLabel = "slimmedElectrons" if useStdName else "heepElectrons"
+        setattr(process,eleLabel,process.heepV70ElectronEmbedder.clone())
+        if useCompactVIDResult:
+            getattr(process,eleLabel).embedFullVIDResult = False
+            getattr(process,eleLabel).compactVIDResultLabel = "heepElectronID_HEEPV70Compact"
+            getattr(process,eleLabel).compactVIDResultMantissaBits = 10
+        process.heepSequence.insert(1,getattr(process,eleLabel))
     else:
-        process.heepSequence.insert(1,process.addHEEPToHEEPElectrons)
+        if useCompactVIDResult:
+            raise RuntimeError("addHEEPV70ElesMiniAOD: useCompactVIDResult needs useFusedEmbedder=True")
+        process.load("HEEP.VID.addHEEPV70ToEles_cfi") 
+        if useStdName:
+            process.heepSequence.insert(1,process.addHEEPToSlimmedElectrons)
+        else:
+            process.heepSequence.insert(1,process.addHEEPToHEEPElectrons)
         
   
+
+#the HEEP information addHEEPV70ElesMiniAODLean can add to the electrons
+#  pass : userInt("heepElectronID_HEEPV70")
+#  bitmap : userInt("heepElectronID_HEEPV70Bitmap")
+#  trkIso : userFloat("trkPtIso")
+#  nrSatCrys : userInt("nrSatCrys")
+#  cutFlowResult : userData<vid::CutFlowResult>("heepElectronID_HEEPV70")
+#  compactResult : userData<HEEPV70CompactResult>("heepElectronID_HEEPV70Compact")
+heepV70LeanOutputs = ("pass","bitmap","trkIso","nrSatCrys","cutFlowResult","compactResult")
+
+#a lean version of addHEEPV70ElesMiniAOD(useFusedEmbedder=True) for jobs which
+#only need some of the HEEP information
+#
+#only the HEEP producers are added, not the rest of egmGsfElectronIDSequence
+#(eg the MVA value maps), and rather than a sequence they are put in the
+#task process.heepTask so they are run unscheduled, ie only if something
+#consumes their products, so the task must be added to a path, eg
+#  process.p = cms.Path(process.heepIdExample,process.heepTask)
+#
+#outputs : the information to add to the electrons (see heepV70LeanOutputs),
+#          only the producers needed for it are run, eg ["pass"] runs VID
+#          and heepIDVarValueMaps, ["trkIso"] runs only heepIDVarValueMaps
+#
+#trkIso and nrSatCrys always come from heepIDVarValueMaps whatever the other
+#outputs are, so they are the values VID cuts on and the same as those of
+#addHEEPV70ElesMiniAOD (HEEPTrkIsoProducer and HEEPNrSatCrysProducer are
+#cheaper but are not used here so the keys never change meaning)
+#
+#returns the output commands dropping the intermediate HEEP products
+#to add to the outputCommands of any OutputModule
+def addHEEPV70ElesMiniAODLean(process,outputs=("pass","bitmap"),useStdName=True):
+    for output in outputs:
+        if output not in heepV70LeanOutputs:
+            raise RuntimeError("addHEEPV70ElesMiniAODLean: output {} is not one of {}".format(output,heepV70LeanOutputs))
+    needVID = any(output in outputs for output in ("pass","bitmap","cutFlowResult","compactResult"))
+
+    process.load("HEEP.VID.heepV70ElectronEmbedder_cfi")
+    eleLabel = "slimmedElectrons" if useStdName else "heepElectrons"
+    embedder = process.heepV70ElectronEmbedder.clone()
+    setattr(process,eleLabel,embedder)
+    process.heepTask = cms.Task(embedder)
+    inputEles = cms.InputTag("slimmedElectrons",processName=cms.InputTag.skipCurrentProcess()) \
+        if useStdName else cms.InputTag("slimmedElectrons")
+
+    #this only defines the VID producers, which are run is decided by what is added to the task
+    setupVIDForHEEPV70(process,useMiniAOD=True)
+    process.heepIDVarValueMaps.elesMiniAOD = inputEles
+    process.egmGsfElectronIDs.physicsObjectSrc = inputEles
+    if needVID or "trkIso" in outputs or "nrSatCrys" in outputs:
+        process.heepTask.add(process.heepIDVarValueMaps)
+    if needVID:
+        process.heepTask.add(process.egmGsfElectronIDs)
+
+    #an empty InputTag means the embedder does not read it (and so its producer is not run)
+    if "trkIso" not in outputs: embedder.trkIsoMap = cms.InputTag("")
+    if "nrSatCrys" not in outputs: embedder.nrSatCrysMap = cms.InputTag("")
+    if "bitmap" not in outputs: embedder.vidBitmap = cms.InputTag("")
+    if not any(output in outputs for output in ("pass","cutFlowResult","compactResult")):
+        embedder.vid = cms.InputTag("")
+    embedder.embedVIDPass = "pass" in outputs
+    embedder.embedFullVIDResult = "cutFlowResult" in outputs
+    if "compactResult" in outputs:
+        embedder.compactVIDResultLabel = "heepElectronID_HEEPV70Compact"
+        embedder.compactVIDResultMantissaBits = 10
+
+    return ["drop *_heepIDVarValueMaps_*_*",
+            "drop *_egmGsfElectronIDs_*_*"]
@@ -0,0 +1,9 @@
+#include "DataFormats/PatCandidates/interface/UserData.h"
+#include "HEEP/VID/interface/HEEPV70CompactResult.h"
+
+namespace HEEP_VID {
+  struct dictionary {
+    HEEPV70CompactResult compactResult;
+    pat::UserHolder<HEEPV70CompactResult> compactResultUserHolder;
+  };
+}
@@ -0,0 +1,163 @@
+#!/usr/bin/env python
+from __future__ import print_function
+
+import argparse
+import json
+import multiprocessing
+import os
+import re
+import subprocess
+import time
+
+#runs heepV70ThreadScaling_cfg.py (or another cfg with the same options) for
+#1 to N threads on the same input and summarises how the job scales
+#
+#for each nr of threads it records
+#  the event loop throughput (from the Timing service, falling back to the wall time of the job)
+#  the cpu efficiency, ie the event loop cpu time / (real time * nr threads)
+#  the peak RSS of the job and the extra RSS per stream compared to one stream
+#
+#with the FastTimerService json of every job it also flags the modules which
+#serialise, ie whose time per event goes up with the nr of threads
+#  "waits": real time per event grows faster than cpu time, eg blocked on a mutex or a legacy module
+#  "slows": cpu time per event grows, eg contended atomics or a shared cache line
+#
+#eg
+#  ./heepThreadScaling.py --maxThreads 16 -- inputFiles=file:miniAOD.root maxEvents=5000
+#the arguments after -- are passed to the cfg
+
+def parse_args():
+    parser = argparse.ArgumentParser(description="sweeps the nr of threads of a HEEP cmsRun job and summarises its scaling")
+    parser.add_argument("--cfg",default=os.path.join(os.path.dirname(os.path.abspath(__file__)),"heepV70ThreadScaling_cfg.py"),help="cfg to run, needs the options nrThreads and moduleTimingFile")
+    parser.add_argument("--maxThreads",type=int,default=multiprocessing.cpu_count(),help="max nr of threads")
+    parser.add_argument("--threads",type=int,nargs="+",help="the nr of threads to run, default powers of 2 up to maxThreads (and maxThreads)")
+    parser.add_argument("--outDir",default="heepThreadScaling",help="directory for the logs, module timings and scaling.json")
+    parser.add_argument("--flagRatio",type=float,default=1.5,help="flag a module if its time per event at N threads is this many times that at 1 thread")
+    parser.add_argument("--minModuleFrac",type=float,default=0.01,help="only flag modules taking at least this fraction of the event time")
+    parser.add_argument("cfgArgs",nargs="*",help="passed to the cfg, eg inputFiles=file:miniAOD.root maxEvents=5000")
+    return parser.parse_args()
+
+def default_threads(max_threads):
+    threads = []
+    nr_threads = 1
+    while nr_threads < max_threads:
+        threads.append(nr_threads)
+        nr_threads *= 2
+    threads.append(max_threads)
+    return threads
+
+def read_timing_summary(log):
+    """the nr of events and the event loop throughput, real and cpu time from the job summary, missing if not present"""
+    summary = {}
+    match = re.search(r"TrigReport Events total =\s*(\d+)",log)
+    if match: summary["nrEvents"] = int(match.group(1))
+    match = re.search(r"Event Throughput:\s*([0-9.eE+-]+)",log)
+    if match: summary["throughput"] = float(match.group(1))
+    match = re.search(r"Time Summary:.*?- Total loop:\s*([0-9.eE+-]+)",log,re.S)
+    if match: summary["realLoop"] = float(match.group(1))
+    match = re.search(r"CPU Summary:.*?- Total loop:\s*([0-9.eE+-]+)",log,re.S)
+    if match: summary["cpuLoop"] = float(match.group(1))
+    return summary
+
+def read_module_timings(filename):
+    """real and cpu ms per event of each module from the FastTimerService json"""
+    if not os.path.exists(filename): return {}
+    with open(filename) as json_file:
+        data = json.load(json_file)
+    modules = {}
+    for module in data.get("modules",[]):
+        nr_events = module.get("events",0)
+        if nr_events == 0 or not module.get("label"): continue
+        modules[module["label"]] = {"type" : module.get("type",""),
+                                    "realPerEvent" : module.get("time_real",0.)/nr_events,
+                                    "cpuPerEvent" : module.get("time_thread",0.)/nr_events}
+    return modules
+
+def run_job(args,nr_threads):
+    log_filename = os.path.join(args.outDir,"log_{}.txt".format(nr_threads))
+    module_timing_filename = os.path.join(args.outDir,"modules_{}.json".format(nr_threads))
+    cmd = ["cmsRun",args.cfg,"nrThreads={}".format(nr_threads),
+           "moduleTimingFile={}".format(module_timing_filename)] + args.cfgArgs
+    print("running {}".format(" ".join(cmd)))
+
+    start = time.time()
+    with open(log_filename,"w") as log_file:
+        proc = subprocess.Popen(cmd,stdout=log_file,stderr=subprocess.STDOUT)
+        #wait4 gives the usage of this job only, unlike getrusage(RUSAGE_CHILDREN)
+        _,status,usage = os.wait4(proc.pid,0)
+    wall = time.time()-start
+    if status != 0:
+        raise RuntimeError("{} failed with status {}, see {}".format(" ".join(cmd),status,log_filename))
+
+    with open(log_filename) as log_file:
+        summary = read_timing_summary(log_file.read())
+    result = {"nrThreads" : nr_threads,
+              "wallTime" : wall,
+              "cpuTime" : usage.ru_utime+usage.ru_stime,
+              "maxRSSMB" : usage.ru_maxrss/1024., #kB on linux
+              "modules" : read_module_timings(module_timing_filename)}
+    result.update(summary)
+    #without the Timing summary the times include the job start up
+    real = result.get("realLoop",wall)
+    cpu = result.get("cpuLoop",result["cpuTime"])
+    result["cpuEff"] = cpu/(real*nr_threads) if real > 0 else 0.
+    return result
+
+def flag_modules(results,flag_ratio,min_module_frac):
+    """the modules whose real or cpu time per event at N threads is flag_ratio times that at 1 thread"""
+    ref = results[0]
+    ref_event_time = sum(module["realPerEvent"] for module in ref["modules"].values())
+    flags = []
+    for result in results[1:]:
+        for label,module in result["modules"].items():
+            ref_module = ref["modules"].get(label)
+            if not ref_module or ref_module["realPerEvent"] < min_module_frac*ref_event_time: continue
+            real_ratio = module["realPerEvent"]/ref_module["realPerEvent"] if ref_module["realPerEvent"] > 0 else 0.
+            cpu_ratio = module["cpuPerEvent"]/ref_module["cpuPerEvent"] if ref_module["cpuPerEvent"] > 0 else 0.
+            if cpu_ratio >= flag_ratio:
+                flags.append({"label" : label,"type" : module["type"],"nrThreads" : result["nrThreads"],
+                              "reason" : "slows","realRatio" : real_ratio,"cpuRatio" : cpu_ratio})
+            elif real_ratio >= flag_ratio:
+                flags.append({"label" : label,"type" : module["type"],"nrThreads" : result["nrThreads"],
+                              "reason" : "waits","realRatio" : real_ratio,"cpuRatio" : cpu_ratio})
+    return flags
+
+def print_summary(results,flags):
+    ref = results[0]
+    ref_throughput = ref.get("throughput",0.)
+    print("{:>8} {:>12} {:>10} {:>8} {:>10} {:>14}".format("threads","events/s","scaling","cpu eff","RSS (MB)","RSS/stream(MB)"))
+    for result in results:
+        throughput = result.get("throughput",0.)
+        scaling = throughput/(ref_throughput*result["nrThreads"]/ref["nrThreads"]) if ref_throughput > 0 else 0.
+        print("{:>8} {:>12.1f} {:>10.2f} {:>8.2f} {:>10.0f} {:>14.1f}".format(
+                result["nrThreads"],throughput,scaling,result["cpuEff"],result["maxRSSMB"],result.get("rssPerStreamMB",0.)))
+    if flags:
+        print("\nmodules which serialise (time per event at N threads / at {} thread(s)):".format(ref["nrThreads"]))
+        for flag in flags:
+            print("  {label} ({type}) at {nrThreads} threads {reason}: real x{realRatio:.2f} cpu x{cpuRatio:.2f}".format(**flag))
+    else:
+        print("\nno modules flagged as serialising")
+
+def main():
+    args = parse_args()
+    if not os.path.isdir(args.outDir): os.makedirs(args.outDir)
+    threads = sorted(set(args.threads if args.threads else default_threads(args.maxThreads)))
+
+    results = [run_job(args,nr_threads) for nr_threads in threads]
+    #the cfgs default to one stream per thread
+    ref = results[0]
+    for result in results[1:]:
+        result["rssPerStreamMB"] = (result["maxRSSMB"]-ref["maxRSSMB"])/(result["nrThreads"]-ref["nrThreads"])
+    #no Timing summary, use the wall time of the job (which includes the start up)
+    for result in results:
+        if "throughput" not in result:
+            result["throughput"] = result.get("nrEvents",0)/result["wallTime"]
+
+    flags = flag_modules(results,args.flagRatio,args.minModuleFrac)
+    print_summary(results,flags)
+
+    with open(os.path.join(args.outDir,"scaling.json"),"w") as out_file:
+        json.dump({"cfg" : args.cfg,"cfgArgs" : args.cfgArgs,"results" : results,"flags" : flags},out_file,indent=2)
+
+if __name__ == "__main__":
+    main()
@@ -7,6 +7,21 @@ options.register ('useMiniAOD',
                   VarParsing.multiplicity.singleton,
                   VarParsing.varType.bool,
                   "use miniAOD rather than AOD")
+options.register ('columnarOutput',
+                  False,
+                  VarParsing.multiplicity.singleton,
+                  VarParsing.varType.bool,
+                  "write the HEEP variables with HEEPV70ColumnarWriter rather than dumping the event")
+options.register ('useHEEPTrkIsoProducer',
+                  False,
+                  VarParsing.multiplicity.singleton,
+                  VarParsing.varType.bool,
+                  "read the trk isol from HEEPTrkIsoProducer, the example then checks it agrees with VID")
+options.register ('useHEEPNrSatCrysProducer',
+                  False,
+                  VarParsing.multiplicity.singleton,
+                  VarParsing.varType.bool,
+                  "read the nr saturated crystals from HEEPNrSatCrysProducer")
 options.parseArguments()
 useMiniAOD=options.useMiniAOD
 
@@ -50,13 +65,58 @@ process.heepIdExample = cms.EDAnalyzer("HEEPV70Example",
                                        nrSatCrysMap=cms.InputTag("heepIDVarValueMaps","eleNrSaturateIn5x5"),
                                        trkIsoMap=cms.InputTag("heepIDVarValueMaps","eleTrkPtIso"),
                                        vid=cms.InputTag("egmGsfElectronIDs:heepElectronID-HEEPV70"),
-                                       vidBitmap=cms.InputTag("egmGsfElectronIDs:heepElectronID-HEEPV70Bitmap")
+                                       vidBitmap=cms.InputTag("egmGsfElectronIDs:heepElectronID-HEEPV70Bitmap"),
+                                       #if set, writes the nr of electrons with each bitmap to this file
+                                       #so any cut combination can be looked at after the job (see VIDBitmapHist.h)
+                                       bitmapHistFile=cms.untracked.string("heepV70BitmapHist.txt"),
+                                       #if set, times each event and writes the throughput and
+                                       #latency percentiles per stream as json (see HEEPTimingStats.h)
+                                       timingFile=cms.untracked.string(""),
+                                       #if true, checks the values read by electron number against
+                                       #those read via edm::Ptr (see ValueMapSpan.h), for debugging
+                                       checkValueMapSpans=cms.untracked.bool(False),
+                                       #if true, recalculates the bitmaps with HEEPV70SIMDEvaluator.h and
+                                       #checks they are the same as VID's (uses rho and the vertices, see the module)
+                                       checkSIMDEvaluator=cms.untracked.bool(False),
+                                       #the debug messages of the electron loop are buffered per stream and written at the
+                                       #end of each lumi, at most maxDiagMsgsPerLumi per category and then one in diagSampleEvery
+                                       #(0 = none) but all are counted (see HEEPDiagnostics.h)
+                                       maxDiagMsgsPerLumi=cms.untracked.uint32(10),
+                                       diagSampleEvery=cms.untracked.uint32(0)
                                        )
 
 process.p = cms.Path(
     process.egmGsfElectronIDSequence* 
     process.heepIdExample) #our analysing example module, replace with your module
 
+#the example checks the trk isol in trkIsoMap against the value VID cut on
+#so this checks HEEPTrkIsoProducer agrees with heepIDVarValueMaps, the nr of
+#electrons which disagree is the vidTrkIsoMismatch count of the job summary
+if options.useHEEPTrkIsoProducer:
+    process.load("HEEP.VID.heepTrkIsoProducer_cfi")
+    process.heepIdExample.trkIsoMap = cms.InputTag("heepTrkIsoProducer","eleTrkPtIso")
+    process.p.insert(1,process.heepTrkIsoProducer)
+
+if options.useHEEPNrSatCrysProducer:
+    process.load("HEEP.VID.heepNrSatCrysProducer_cfi")
+    process.heepIdExample.nrSatCrysMap = cms.InputTag("heepNrSatCrysProducer","eleNrSaturateIn5x5")
+    process.p.insert(1,process.heepNrSatCrysProducer)
+
+#a much faster alternative to dumping the event below if all you need are the HEEP variables
+#writes a simple columnar file which can be read with HEEP/VID/interface/HEEPColumnarReader.h
+if options.columnarOutput:
+    process.heepColumnarWriter = cms.EDAnalyzer("HEEPV70ColumnarWriter",
+                                                elesAOD=cms.InputTag("gedGsfElectrons"),
+                                                elesMiniAOD=cms.InputTag("slimmedElectrons"),
+                                                nrSatCrysMap=cms.InputTag("heepIDVarValueMaps","eleNrSaturateIn5x5"),
+                                                trkIsoMap=cms.InputTag("heepIDVarValueMaps","eleTrkPtIso"),
+                                                vid=cms.InputTag("egmGsfElectronIDs:heepElectronID-HEEPV70"),
+                                                vidBitmap=cms.InputTag("egmGsfElectronIDs:heepElectronID-HEEPV70Bitmap"),
+                                                outputFile=cms.untracked.string("heepV70Ntup.heepcol"),
+                                                rowGroupSize=cms.untracked.uint32(65536)
+                                                )
+    process.p += process.heepColumnarWriter
+
 #dumps the products made for easier debugging, you wouldnt normally need to do this
 #edmDumpEventContent outputTest.root shows you all the products produced
 #will be very slow when this is happening
@@ -77,4 +137,5 @@ process.output = cms.OutputModule("PoolOutputModule",
 )
 process.output.outputCommands = cms.untracked.vstring('keep *_*_*_*',
                                                            )
-process.outPath = cms.EndPath(process.output)
+if not options.columnarOutput:
+    process.outPath = cms.EndPath(process.output)
@@ -32,10 +32,22 @@ process.source = cms.Source ("PoolSource",fileNames = cms.untracked.vstring(
 #it creates a sequence "process.heepSequence" which we add to our path
 from HEEP.VID.tools import addHEEPV70ElesMiniAOD
 addHEEPV70ElesMiniAOD(process,useStdName=True)
+#if you only need some of the HEEP information (eg just pass/fail), the lean version
+#runs only the producers needed for it and only when they are consumed, ie
+#  from HEEP.VID.tools import addHEEPV70ElesMiniAODLean
+#  addHEEPV70ElesMiniAODLean(process,outputs=["pass","bitmap"],useStdName=True)
+#and then the path is cms.Path(process.heepIdExample,process.heepTask)
+#(this example reads everything so it would need outputs=["pass","bitmap","trkIso","nrSatCrys","cutFlowResult"])
 
 #this is our example analysis module reading the results, you will have your own module
 process.heepIdExample = cms.EDAnalyzer("HEEPV70PATExample",
                                        eles=cms.InputTag("slimmedElectrons"),
+                                       #if set, writes the nr of electrons with each bitmap to this file
+                                       #so any cut combination can be looked at after the job (see VIDBitmapHist.h)
+                                       bitmapHistFile=cms.untracked.string("heepV70BitmapHist.txt"),
+                                       #if set, times each event and writes the throughput and
+                                       #latency percentiles per stream as json (see HEEPTimingStats.h)
+                                       timingFile=cms.untracked.string("")
                                        )
 
 process.p = cms.Path(
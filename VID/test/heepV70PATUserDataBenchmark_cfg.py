@@ -0,0 +1,45 @@
+import FWCore.ParameterSet.Config as cms
+
+from FWCore.ParameterSet.VarParsing import VarParsing
+
+# set up process
+process = cms.Process("HEEP")
+process.load("FWCore.MessageService.MessageLogger_cfi")
+process.MessageLogger.cerr.FwkReport = cms.untracked.PSet(
+    reportEvery = cms.untracked.int32(1000),
+    limit = cms.untracked.int32(10000000)
+)
+process.load('Configuration.StandardSequences.FrontierConditions_GlobalTag_cff')
+process.load('Configuration.StandardSequences.GeometryRecoDB_cff')
+process.load('Configuration.StandardSequences.MagneticField_cff')
+
+#setup global tag
+from Configuration.AlCa.GlobalTag import GlobalTag
+from Configuration.AlCa.autoCond import autoCond
+process.GlobalTag = GlobalTag(process.GlobalTag, '80X_mcRun2_asymptotic_2016_TrancheIV_v4', '') #
+
+
+process.maxEvents = cms.untracked.PSet( input = cms.untracked.int32(-1) )
+process.source = cms.Source ("PoolSource",fileNames = cms.untracked.vstring(
+        '/store/mc/RunIISpring16MiniAODv2/ZToEE_NNPDF30_13TeV-powheg_M_200_400/MINIAODSIM/PUSpring16RAWAODSIM_reHLT_80X_mcRun2_asymptotic_v14-v1/20000/0C242E56-BA3A-E611-9B2D-0242AC130004.root',
+        )
+)
+
+#we setup the HEEP ID V7.0 and enable VID via the following function
+#and then add it to a new collection of pat::Electrons
+#there is the option to call the new collection "slimmedElectrons" (useStdName=True)
+#otherwise it calls them "heepElectrons"
+#it creates a sequence "process.heepSequence" which we add to our path
+from HEEP.VID.tools import addHEEPV70ElesMiniAOD
+addHEEPV70ElesMiniAOD(process,useStdName=True)
+
+#times reading the HEEP user data via the string lookups vs HEEPUserDataAccessor
+#the results are printed at the end of the job
+process.heepUserDataBenchmark = cms.EDAnalyzer("HEEPV70PATUserDataBenchmark",
+                                               eles=cms.InputTag("slimmedElectrons"),
+                                               nrRepeats=cms.untracked.int32(100)
+                                               )
+
+process.p = cms.Path(
+    process.heepSequence*
+    process.heepUserDataBenchmark)
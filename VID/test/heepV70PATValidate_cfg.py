@@ -1,6 +1,18 @@
 import FWCore.ParameterSet.Config as cms
 
 from FWCore.ParameterSet.VarParsing import VarParsing
+options = VarParsing ('analysis')
+options.register ('useFusedEmbedder',
+                  False,
+                  VarParsing.multiplicity.singleton,
+                  VarParsing.varType.bool,
+                  "use HEEPV70ElectronEmbedder rather than the EGExtraInfoModifiers")
+options.register ('useCompactVIDResult',
+                  False,
+                  VarParsing.multiplicity.singleton,
+                  VarParsing.varType.bool,
+                  "embed and validate a HEEPV70CompactResult rather than the vid::CutFlowResult (implies useFusedEmbedder)")
+options.parseArguments()
 
 # set up process
 process = cms.Process("HEEP")
@@ -26,17 +38,32 @@ process.source = cms.Source ("PoolSource",fileNames = cms.untracked.vstring(
 )
 
 from HEEP.VID.tools import addHEEPV70ElesMiniAOD
-addHEEPV70ElesMiniAOD(process,useStdName=False)
+addHEEPV70ElesMiniAOD(process,useStdName=False,
+                      useFusedEmbedder=options.useFusedEmbedder or options.useCompactVIDResult,
+                      useCompactVIDResult=options.useCompactVIDResult)
 
 #this is our example analysis module reading the results
 process.heepIdExample = cms.EDAnalyzer("HEEPV70PATValidation",
-                                       eles=cms.InputTag("slimmedElectrons"),
+                                       eles=cms.InputTag("heepElectrons"),
                                        orgEles=cms.InputTag("slimmedElectrons",processName=cms.InputTag.skipCurrentProcess()),
                                        trkIsoMap=cms.InputTag("heepIDVarValueMaps","eleTrkPtIso"),
                                        nrSatCrysMap=cms.InputTag("heepIDVarValueMaps","eleNrSaturateIn5x5"),
-                                       vid=cms.InputTag("egmGsfElectronIDs:heepElectronID-HEEPV70")
+                                       vid=cms.InputTag("egmGsfElectronIDs:heepElectronID-HEEPV70"),
+                                       vidBitmap=cms.InputTag("egmGsfElectronIDs:heepElectronID-HEEPV70Bitmap"),
+                                       #set to true to match the electrons by eta/phi, allowing
+                                       #the collections to be filtered or reordered
+                                       matchByEtaPhi=cms.untracked.bool(False),
+                                       #the precision the HEEPV70CompactResult values are validated to
+                                       #(its bitmap must always be exact), only used with useCompactVIDResult
+                                       compactVIDResultMantissaBits=cms.untracked.uint32(10),
+                                       #if set, times each event and writes the throughput and
+                                       #latency percentiles per stream as json (see HEEPTimingStats.h)
+                                       timingFile=cms.untracked.string("")
                                        )
 
+if options.useCompactVIDResult:
+    process.heepIdExample.compactVIDResultMantissaBits = process.heepElectrons.compactVIDResultMantissaBits.value()
+
 process.p = cms.Path(
     process.heepSequence*
     process.heepIdExample) #our analysing example module, replace with your module
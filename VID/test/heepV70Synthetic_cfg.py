@@ -0,0 +1,62 @@
+import FWCore.ParameterSet.Config as cms
+
+from FWCore.ParameterSet.VarParsing import VarParsing
+options = VarParsing ('analysis')
+options.register('nrThreads',1,options.multiplicity.singleton,options.varType.int,"nr of threads (and streams)")
+options.register('nrElesMean',2.,options.multiplicity.singleton,options.varType.float,"mean nr of electrons per event")
+options.register('timingFile','',options.multiplicity.singleton,options.varType.string,"if set, the analyzers write their timings to <module>_<timingFile>")
+options.maxEvents = 100000
+options.parseArguments()
+
+#runs the HEEP example and validation modules on random electrons (see HEEPV70SyntheticEleProducer)
+#so they can be tested and timed without input files or a global tag, eg
+#  cmsRun heepV70Synthetic_cfg.py maxEvents=1000000 nrThreads=8 timingFile=timing.json
+
+process = cms.Process("HEEP")
+process.load("FWCore.MessageService.MessageLogger_cfi")
+process.MessageLogger.cerr.FwkReport = cms.untracked.PSet(
+    reportEvery = cms.untracked.int32(100000),
+    limit = cms.untracked.int32(10000000)
+)
+process.options = cms.untracked.PSet(
+    numberOfThreads = cms.untracked.uint32(options.nrThreads),
+    numberOfStreams = cms.untracked.uint32(0),
+)
+process.maxEvents = cms.untracked.PSet( input = cms.untracked.int32(options.maxEvents) )
+process.source = cms.Source("EmptySource")
+
+process.load("HEEP.VID.heepV70SyntheticEleProducer_cfi")
+process.heepV70SyntheticEles.nrElesMean = options.nrElesMean
+
+def timingFile(moduleName):
+    return moduleName+"_"+options.timingFile if options.timingFile else ""
+
+process.heepIdExample = cms.EDAnalyzer("HEEPV70Example",
+                                       elesAOD=cms.InputTag("heepV70SyntheticEles"),
+                                       elesMiniAOD=cms.InputTag("heepV70SyntheticEles"),
+                                       nrSatCrysMap=cms.InputTag("heepV70SyntheticEles","eleNrSaturateIn5x5"),
+                                       trkIsoMap=cms.InputTag("heepV70SyntheticEles","eleTrkPtIso"),
+                                       vid=cms.InputTag("heepV70SyntheticEles","heepElectronID-HEEPV70"),
+                                       vidBitmap=cms.InputTag("heepV70SyntheticEles","heepElectronID-HEEPV70Bitmap"),
+                                       timingFile=cms.untracked.string(timingFile("heepIdExample")),
+                                       )
+process.heepIdPATExample = cms.EDAnalyzer("HEEPV70PATExample",
+                                          eles=cms.InputTag("heepV70SyntheticEles"),
+                                          timingFile=cms.untracked.string(timingFile("heepIdPATExample")),
+                                          )
+#the user data and value maps are of the same electrons so we validate them against themselves
+process.heepIdValidation = cms.EDAnalyzer("HEEPV70PATValidation",
+                                          eles=cms.InputTag("heepV70SyntheticEles"),
+                                          orgEles=cms.InputTag("heepV70SyntheticEles"),
+                                          trkIsoMap=cms.InputTag("heepV70SyntheticEles","eleTrkPtIso"),
+                                          nrSatCrysMap=cms.InputTag("heepV70SyntheticEles","eleNrSaturateIn5x5"),
+                                          vid=cms.InputTag("heepV70SyntheticEles","heepElectronID-HEEPV70"),
+                                          vidBitmap=cms.InputTag("heepV70SyntheticEles","heepElectronID-HEEPV70Bitmap"),
+                                          timingFile=cms.untracked.string(timingFile("heepIdValidation")),
+                                          )
+
+process.p = cms.Path(
+    process.heepV70SyntheticEles*
+    process.heepIdExample*
+    process.heepIdPATExample*
+    process.heepIdValidation)
@@ -0,0 +1,109 @@
+import FWCore.ParameterSet.Config as cms
+
+from FWCore.ParameterSet.VarParsing import VarParsing
+options = VarParsing ('analysis')
+options.register('nrThreads',1,options.multiplicity.singleton,options.varType.int,"nr of threads")
+options.register('nrStreams',0,options.multiplicity.singleton,options.varType.int,"nr of streams, 0 = nrThreads")
+options.register('globalTag','80X_mcRun2_asymptotic_2016_TrancheIV_v4',options.multiplicity.singleton,options.varType.string,"global tag (miniAOD input only)")
+options.register('moduleTimingFile','',options.multiplicity.singleton,options.varType.string,"if set, the FastTimerService writes the per module timings here as json")
+options.register('timingFile','',options.multiplicity.singleton,options.varType.string,"if set, the HEEP analyzers write their timings to <module>_<timingFile>")
+options.register('useFusedEmbedder',False,options.multiplicity.singleton,options.varType.bool,"miniAOD input only: use HEEPV70ElectronEmbedder rather than the modifiers")
+options.register('useCompactVIDResult',False,options.multiplicity.singleton,options.varType.bool,"miniAOD input only: embed the HEEPV70CompactResult rather than the vid::CutFlowResult (needs useFusedEmbedder)")
+options.maxEvents = 10000
+options.parseArguments()
+
+#the benchmark of how the HEEP sequence scales with the nr of threads, the job
+#is the same for any nr of threads so heepThreadScaling.py can run it for 1 to N
+#threads and compare the throughput, cpu efficiency, memory and module timings
+#
+#with inputFiles (miniAOD) it runs egmGsfElectronIDSequence, the HEEP modifiers
+#and HEEPV70PATExample, ie heepV70PATExample_cfg.py without the output
+#without inputFiles it runs the analyzers on HEEPV70SyntheticEleProducer
+#electrons, ie heepV70Synthetic_cfg.py, which needs no input or global tag
+#
+#the input should be local (eg xrdcp it first) so the job isnt limited by the network
+#and for miniAOD maxEvents should be at most the nr of events in the files so every
+#job processes the same events
+#
+#eg
+#  cmsRun heepV70ThreadScaling_cfg.py inputFiles=file:miniAOD.root maxEvents=5000 nrThreads=8 moduleTimingFile=modules.json
+#
+#useFusedEmbedder compares the cpu and memory of HEEPV70ElectronEmbedder to the five modifiers,
+#run once with each at one thread and compare the peak RSS in scaling.json and the time of the
+#slimmedElectrons module (the modifiers or the embedder) in the FastTimerService json, eg
+#  ./heepThreadScaling.py --threads 1 --outDir modifiers -- inputFiles=file:miniAOD.root maxEvents=5000
+#  ./heepThreadScaling.py --threads 1 --outDir embedder -- inputFiles=file:miniAOD.root maxEvents=5000 useFusedEmbedder=True
+#heepV70PATValidate_cfg.py checks the two give the same electrons
+
+process = cms.Process("HEEP")
+process.load("FWCore.MessageService.MessageLogger_cfi")
+process.MessageLogger.cerr.FwkReport = cms.untracked.PSet(
+    reportEvery = cms.untracked.int32(10000),
+    limit = cms.untracked.int32(10000000)
+)
+process.options = cms.untracked.PSet(
+    numberOfThreads = cms.untracked.uint32(options.nrThreads),
+    numberOfStreams = cms.untracked.uint32(options.nrStreams),
+    wantSummary = cms.untracked.bool(True), #for the nr of events processed
+)
+process.maxEvents = cms.untracked.PSet( input = cms.untracked.int32(options.maxEvents) )
+
+#the Timing service prints the event loop throughput and cpu time at the end of the job
+#which is what heepThreadScaling.py reads
+process.Timing = cms.Service("Timing",
+                             summaryOnly = cms.untracked.bool(True),
+                             )
+if options.moduleTimingFile:
+    process.load("HLTrigger.Timer.FastTimerService_cfi")
+    process.FastTimerService.enableDQM = False
+    process.FastTimerService.printRunSummary = False
+    process.FastTimerService.printJobSummary = False
+    process.FastTimerService.writeJSONSummary = True
+    process.FastTimerService.jsonFileName = options.moduleTimingFile
+
+def timingFile(moduleName):
+    return moduleName+"_"+options.timingFile if options.timingFile else ""
+
+if options.inputFiles:
+    process.load('Configuration.StandardSequences.FrontierConditions_GlobalTag_cff')
+    process.load('Configuration.StandardSequences.GeometryRecoDB_cff')
+    process.load('Configuration.StandardSequences.MagneticField_cff')
+    from Configuration.AlCa.GlobalTag import GlobalTag
+    process.GlobalTag = GlobalTag(process.GlobalTag, options.globalTag, '')
+
+    process.source = cms.Source("PoolSource",fileNames = cms.untracked.vstring(options.inputFiles))
+
+    from HEEP.VID.tools import addHEEPV70ElesMiniAOD
+    addHEEPV70ElesMiniAOD(process,useStdName=True,
+                          useFusedEmbedder=options.useFusedEmbedder,
+                          useCompactVIDResult=options.useCompactVIDResult)
+
+    process.heepIdExample = cms.EDAnalyzer("HEEPV70PATExample",
+                                           eles=cms.InputTag("slimmedElectrons"),
+                                           bitmapHistFile=cms.untracked.string(""),
+                                           timingFile=cms.untracked.string(timingFile("heepIdExample")),
+                                           )
+    process.p = cms.Path(
+        process.heepSequence*
+        process.heepIdExample)
+else:
+    process.source = cms.Source("EmptySource")
+    process.load("HEEP.VID.heepV70SyntheticEleProducer_cfi")
+
+    process.heepIdExample = cms.EDAnalyzer("HEEPV70Example",
+                                           elesAOD=cms.InputTag("heepV70SyntheticEles"),
+                                           elesMiniAOD=cms.InputTag("heepV70SyntheticEles"),
+                                           nrSatCrysMap=cms.InputTag("heepV70SyntheticEles","eleNrSaturateIn5x5"),
+                                           trkIsoMap=cms.InputTag("heepV70SyntheticEles","eleTrkPtIso"),
+                                           vid=cms.InputTag("heepV70SyntheticEles","heepElectronID-HEEPV70"),
+                                           vidBitmap=cms.InputTag("heepV70SyntheticEles","heepElectronID-HEEPV70Bitmap"),
+                                           timingFile=cms.untracked.string(timingFile("heepIdExample")),
+                                           )
+    process.heepIdPATExample = cms.EDAnalyzer("HEEPV70PATExample",
+                                              eles=cms.InputTag("heepV70SyntheticEles"),
+                                              timingFile=cms.untracked.string(timingFile("heepIdPATExample")),
+                                              )
+    process.p = cms.Path(
+        process.heepV70SyntheticEles*
+        process.heepIdExample*
+        process.heepIdPATExample)